@@ -63,6 +63,7 @@ Config::Config()
       skipNonText_(true),
       saveUnmodified_(false),
       selectionHighlighting_(false),
+      documentOverview_(false),
       pastePaths_(false),
       closeWithLastTab_(false),
       sharedSearchHistory_(false),
@@ -77,6 +78,7 @@ Config::Config()
       curRecentFilesNumber_(10),  // not needed
       autoSaveInterval_(1),       // not needed
       textTabSize_(4),            // not needed
+      undoMemoryLimit_(256),
       winSize_(QSize(700, 500)),
       startSize_(QSize(700, 500)),
       winPos_(QPoint(0, 0)),
@@ -259,11 +261,16 @@ void Config::readConfig() {
     if (settings.value("selectionHighlighting").toBool())
         selectionHighlighting_ = true;  // false by default
 
+    if (settings.value("documentOverview").toBool())
+        documentOverview_ = true;  // false by default
+
     if (settings.value("pastePaths").toBool())
         pastePaths_ = true;  // false by default
 
     maxSHSize_ = std::clamp(settings.value("maxSHSize", 2).toInt(), 1, 10);
 
+    undoMemoryLimit_ = std::clamp(settings.value("undoMemoryLimit", 256).toInt(), 0, 4096);  // in MiB
+
     /* don't let the dark bg be darker than #e6e6e6 */
     lightBgColorValue_ = std::clamp(settings.value("lightBgColorValue", 255).toInt(), 230, 255);
 
@@ -477,8 +484,10 @@ void Config::writeConfig() {
     settings.setValue("skipNonText", skipNonText_);
     settings.setValue("saveUnmodified", saveUnmodified_);
     settings.setValue("selectionHighlighting", selectionHighlighting_);
+    settings.setValue("documentOverview", documentOverview_);
     settings.setValue("pastePaths", pastePaths_);
     settings.setValue("maxSHSize", maxSHSize_);
+    settings.setValue("undoMemoryLimit", undoMemoryLimit_);
 
     settings.setValue("lightBgColorValue", lightBgColorValue_);
     settings.setValue("dateFormat", dateFormat_);
@@ -186,6 +186,9 @@ class Config {
 
     bool getSkipNonText() const { return skipNonText_; }
     void setSkipNonText(bool skip) { skipNonText_ = skip; }
+
+    int getUndoMemoryLimit() const { return undoMemoryLimit_; }  // in MiB (0 means no limit)
+    void setUndoMemoryLimit(int limit) { undoMemoryLimit_ = std::clamp(limit, 0, 4096); }
     /*************************/
     bool getExecuteScripts() const { return executeScripts_; }
     void setExecuteScripts(bool execute) { executeScripts_ = execute; }
@@ -267,6 +270,9 @@ class Config {
     bool getSelectionHighlighting() const { return selectionHighlighting_; }
     void setSelectionHighlighting(bool enable) { selectionHighlighting_ = enable; }
     /*************************/
+    bool getDocumentOverview() const { return documentOverview_; }
+    void setDocumentOverview(bool overview) { documentOverview_ = overview; }
+    /*************************/
     bool getPastePaths() const { return pastePaths_; }
     void setPastePaths(bool pastPaths) { pastePaths_ = pastPaths; }
     /*************************/
@@ -319,11 +325,11 @@ class Config {
         autoBracket_, lineByDefault_, syntaxByDefault_, showWhiteSpace_, showEndings_, textMargin_, isMaxed_, isFull_,
         darkColScheme_, thickCursor_, tabWrapAround_, hideSingleTab_, executeScripts_, appendEmptyLine_,
         removeTrailingSpaces_, openInWindows_, nativeDialog_, inertialScrolling_, autoSave_, skipNonText_,
-        saveUnmodified_, selectionHighlighting_, pastePaths_, closeWithLastTab_, sharedSearchHistory_,
-        disableMenubarAccel_, sysIcons_;
+        saveUnmodified_, selectionHighlighting_, documentOverview_, pastePaths_, closeWithLastTab_,
+        sharedSearchHistory_, disableMenubarAccel_, sysIcons_;
     int vLineDistance_, tabPosition_, maxSHSize_, lightBgColorValue_, darkBgColorValue_, recentFilesNumber_,
         curRecentFilesNumber_,  // the start value of recentFilesNumber_ -- fixed during a session
-        autoSaveInterval_, textTabSize_;
+        autoSaveInterval_, textTabSize_, undoMemoryLimit_;
     QString dateFormat_;
     QSize winSize_, startSize_, prefSize_;
     QPoint winPos_;
@@ -3,9 +3,26 @@
  */
 
 #include "encoding.h"
+#include <QStringDecoder>
+#include <QStringEncoder>
+#include <optional>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <iconv.h>
+
+#define DETECTION_SAMPLE 65536  // in bytes
+#define MIN_DETECTION_SCORE 0.2
 
 namespace FeatherPad {
 
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+static const char* const UTF16_HOST = "UTF-16LE";
+#else
+static const char* const UTF16_HOST = "UTF-16BE";
+#endif
+
 bool validateUTF8(const QByteArray byteArray) {
     const unsigned char* p = reinterpret_cast<const unsigned char*>(byteArray.constData());
     const unsigned char* end = p + byteArray.size();
@@ -87,12 +104,222 @@ bool validateUTF8(const QByteArray byteArray) {
     return true;
 }
 
+/*************************/
+static std::optional<QStringConverter::Encoding> builtinEncoding(const QString& charset) {
+    if (charset.isEmpty() || charset.compare("UTF-8", Qt::CaseInsensitive) == 0)
+        return QStringConverter::Utf8;
+    if (charset.compare("UTF-16", Qt::CaseInsensitive) == 0)
+        return QStringConverter::Utf16;
+    if (charset.compare("UTF-32", Qt::CaseInsensitive) == 0)
+        return QStringConverter::Utf32;
+    if (charset.compare("ISO-8859-1", Qt::CaseInsensitive) == 0)
+        return QStringConverter::Latin1;
+    return std::nullopt;
+}
+/*************************/
+const QStringList& legacyEncodings() {
+    static const QStringList encodings = {QStringLiteral("Windows-1251"), QStringLiteral("KOI8-R"),
+                                          QStringLiteral("Shift_JIS"),    QStringLiteral("EUC-JP"),
+                                          QStringLiteral("GB18030"),      QStringLiteral("Big5"),
+                                          QStringLiteral("EUC-KR")};
+    return encodings;
+}
+/*************************/
+QString decodeText(const QByteArray& data, const QString& charset) {
+    if (auto encoding = builtinEncoding(charset)) {
+        QStringDecoder decoder(*encoding);
+        return decoder.decode(data);
+    }
+
+    iconv_t cd = iconv_open(UTF16_HOST, charset.toLatin1().constData());
+    if (cd == reinterpret_cast<iconv_t>(-1)) {
+        QStringDecoder decoder(QStringConverter::Latin1);
+        return decoder.decode(data);
+    }
+
+    /* a character never takes fewer bytes in a legacy encoding than
+       UTF-16 units, so the text is usually decoded without reallocation */
+    QString text(data.size(), Qt::Uninitialized);
+    char* in = const_cast<char*>(data.constData());
+    size_t inLeft = data.size();
+    char* out = reinterpret_cast<char*>(text.data());
+    size_t outLeft = text.size() * sizeof(char16_t);
+    while (inLeft > 0) {
+        if (iconv(cd, &in, &inLeft, &out, &outLeft) != static_cast<size_t>(-1))
+            break;
+        if (errno == E2BIG || outLeft < sizeof(char16_t)) {
+            const qsizetype written = out - reinterpret_cast<char*>(text.data());
+            text.resize(text.size() + static_cast<qsizetype>(inLeft) + 16);
+            out = reinterpret_cast<char*>(text.data()) + written;
+            outLeft = text.size() * sizeof(char16_t) - written;
+            continue;
+        }
+        /* an invalid or truncated sequence: replace a byte and go on */
+        const char16_t replacement = QChar::ReplacementCharacter;
+        std::memcpy(out, &replacement, sizeof(char16_t));
+        out += sizeof(char16_t);
+        outLeft -= sizeof(char16_t);
+        ++in;
+        --inLeft;
+        iconv(cd, nullptr, nullptr, nullptr, nullptr);  // reset the shift state
+    }
+    iconv_close(cd);
+    text.truncate((out - reinterpret_cast<char*>(text.data())) / static_cast<qsizetype>(sizeof(char16_t)));
+    return text;
+}
+/*************************/
+QByteArray encodeText(const QString& text, const QString& charset) {
+    if (auto encoding = builtinEncoding(charset)) {
+        QStringEncoder encoder(*encoding, *encoding == QStringConverter::Utf16
+                                              ? QStringConverter::Flag::WriteBom  // needed with fwrite()
+                                              : QStringConverter::Flag::Default);
+        return encoder.encode(text);
+    }
+
+    iconv_t cd = iconv_open(charset.toLatin1().constData(), UTF16_HOST);
+    if (cd == reinterpret_cast<iconv_t>(-1)) {
+        QStringEncoder encoder(QStringConverter::Latin1);
+        return encoder.encode(text);
+    }
+
+    QByteArray res(text.size() * 2 + 16, Qt::Uninitialized);
+    char* in = reinterpret_cast<char*>(const_cast<QChar*>(text.constData()));
+    size_t inLeft = text.size() * sizeof(char16_t);
+    char* out = res.data();
+    size_t outLeft = res.size();
+    for (;;) {
+        const bool flushing = inLeft == 0;
+        size_t r = flushing ? iconv(cd, nullptr, nullptr, &out, &outLeft)  // write the final shift sequence
+                            : iconv(cd, &in, &inLeft, &out, &outLeft);
+        if (r != static_cast<size_t>(-1)) {
+            if (flushing)
+                break;
+            continue;
+        }
+        if (errno == E2BIG || outLeft == 0) {
+            const qsizetype written = out - res.data();
+            res.resize(res.size() + static_cast<qsizetype>(inLeft) * 2 + 16);
+            out = res.data() + written;
+            outLeft = res.size() - written;
+            continue;
+        }
+        if (flushing)
+            break;
+        /* an unencodable character (or a lone surrogate) */
+        *out++ = '?';
+        --outLeft;
+        const size_t skip = inLeft >= 2 * sizeof(char16_t) &&
+                                    QChar::isHighSurrogate(*reinterpret_cast<const char16_t*>(in)) &&
+                                    QChar::isLowSurrogate(*reinterpret_cast<const char16_t*>(in + sizeof(char16_t)))
+                                ? 2 * sizeof(char16_t)
+                                : sizeof(char16_t);
+        in += std::min(skip, inLeft);
+        inLeft -= std::min(skip, inLeft);
+    }
+    iconv_close(cd);
+    res.truncate(out - res.data());
+    return res;
+}
+/*************************/
+/* The most frequent non-ASCII characters of the languages that are usually
+   written in the legacy encodings. They are used for guessing the encoding. */
+static bool isFrequentJapanese(char16_t c) {
+    return (c >= 0x3041 && c <= 0x309F)     // hiragana
+           || (c >= 0x30A1 && c <= 0x30FA)  // katakana
+           || c == 0x3001 || c == 0x3002;   // ideographic comma and full stop
+}
+static bool isFrequentSimplifiedChinese(char16_t c) {
+    static const QString frequent = QString::fromUtf8(
+        "的一是不了在人有我他这个们中来上大为和国地到以说时要就出会也你对生能子那得于着下自之年过发后作里用道"
+        "，。、");
+    return frequent.contains(QChar(c));
+}
+static bool isFrequentTraditionalChinese(char16_t c) {
+    static const QString frequent = QString::fromUtf8(
+        "的一是不了在人有我他這個們中來上大為和國地到以說時要就出會也你對生能子那得於著下自之年過發後作裡用道"
+        "，。、");
+    return frequent.contains(QChar(c));
+}
+static bool isFrequentKorean(char16_t c) {
+    static const QString frequent = QString::fromUtf8(
+        "이다는의에가을를하고서한기지리로사자도어수요있인그정니대아해시라나일들적으과");
+    return frequent.contains(QChar(c));
+}
+static bool isFrequentRussian(char16_t c) {
+    static const QString frequent = QString::fromUtf8("оеаинтсрвлкмдпуяыь");
+    return frequent.contains(QChar(c));
+}
+
+struct legacyCandidate {
+    const char* name;
+    bool singleByte;
+    bool (*isFrequent)(char16_t);
+};
+
+/* A statistical guess for a text that isn't valid UTF-8: the sample is decoded with each
+   candidate and scored by the ratio of the frequent characters of its language to all
+   non-ASCII characters. Decodings with invalid sequences are ruled out, and so are the
+   Cyrillic single-byte encodings when most non-ASCII bytes stick to ASCII letters
+   (as accented letters do in Western texts). */
+static QString guessLegacyCharset(const QByteArray& sample) {
+    static const legacyCandidate candidates[] = {
+        {"Windows-1251", true, isFrequentRussian},     {"KOI8-R", true, isFrequentRussian},
+        {"Shift_JIS", false, isFrequentJapanese},      {"EUC-JP", false, isFrequentJapanese},
+        {"GB18030", false, isFrequentSimplifiedChinese}, {"Big5", false, isFrequentTraditionalChinese},
+        {"EUC-KR", false, isFrequentKorean}};
+
+    /* non-ASCII bytes beside ASCII letters */
+    int highBytes = 0, mixed = 0;
+    const int n = sample.size();
+    for (int i = 0; i < n; ++i) {
+        if (static_cast<unsigned char>(sample.at(i)) < 0x80)
+            continue;
+        ++highBytes;
+        if ((i > 0 && std::isalpha(static_cast<unsigned char>(sample.at(i - 1))))
+            || (i + 1 < n && std::isalpha(static_cast<unsigned char>(sample.at(i + 1))))) {
+            ++mixed;
+        }
+    }
+    if (highBytes == 0)
+        return QString();
+
+    QString best;
+    double bestScore = MIN_DETECTION_SCORE;
+    for (const auto& candidate : candidates) {
+        if (candidate.singleByte && mixed * 5 > highBytes)
+            continue;
+        const QString text = decodeText(sample, QString::fromLatin1(candidate.name));
+        int nonAscii = 0, invalid = 0, frequent = 0;
+        for (const QChar& c : text) {
+            const char16_t u = c.unicode();
+            if (u < 0x80)
+                continue;
+            ++nonAscii;
+            if (u == QChar::ReplacementCharacter || (u >= 0xE000 && u <= 0xF8FF))  // also private use
+                ++invalid;
+            else if (candidate.isFrequent(u))
+                ++frequent;
+        }
+        /* tolerate a sequence that is truncated at the end of the sample */
+        if (nonAscii == 0 || invalid > 1 + nonAscii / 200)
+            continue;
+        const double score = static_cast<double>(frequent) / nonAscii;
+        if (score > bestScore) {
+            bestScore = score;
+            best = QString::fromLatin1(candidate.name);
+        }
+    }
+    return best;
+}
 /*************************/
 const QString detectCharset(const QByteArray& byteArray) {
     if (validateUTF8(byteArray))
         return QStringLiteral("UTF-8");
-    /* fallback: legacy encodings are no longer supported on Qt6+ by default,
-       so we just return ISO-8859-1 here */
+    /* the guess is made on a bounded sample because
+       this function is called in the loading thread */
+    QString charset = guessLegacyCharset(byteArray.left(DETECTION_SAMPLE));
+    if (!charset.isEmpty())
+        return charset;
     return QStringLiteral("ISO-8859-1");
 }
 
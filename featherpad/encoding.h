@@ -21,11 +21,21 @@
 #define ENCODING_H
 
 #include <QString>
+#include <QStringList>
 
 namespace FeatherPad {
 
 const QString detectCharset(const QByteArray& byteArray);
 
+/* The legacy encodings that are offered in the Encoding menu. They are
+   handled by iconv because Qt6 only has built-in Unicode and Latin-1 codecs. */
+const QStringList& legacyEncodings();
+
+/* Decode/encode with any of the above or the built-in encodings. Invalid bytes
+   become U+FFFD on decoding and unencodable characters become '?' on encoding. */
+QString decodeText(const QByteArray& data, const QString& charset);
+QByteArray encodeText(const QString& text, const QString& charset);
+
 }
 
 #endif  // ENCODING_H
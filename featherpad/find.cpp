@@ -46,6 +46,8 @@ void FPwin::find(bool forward) {
     disconnect(textEdit, &TextEdit::updateRect, this, &FPwin::hlight);
     disconnect(textEdit, &QPlainTextEdit::textChanged, this, &FPwin::hlight);
 
+    textEdit->setSearchMarkers(txt, getSearchFlags(), tabPage->matchRegex());
+
     if (txt.isEmpty()) {
         /* remove all yellow and green highlights */
         QList<QTextEdit::ExtraSelection> es;
@@ -177,6 +179,7 @@ void FPwin::searchFlagChanged() {
         textEdit->setTextCursor(start);
     }
 
+    textEdit->setSearchMarkers(textEdit->getSearchedText(), getSearchFlags(), tabPage->matchRegex());
     hlight();
 }
 /*************************/
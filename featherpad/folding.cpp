@@ -0,0 +1,373 @@
+/*
+ * Copyright (C) Pedram Pourang (aka Tsu Jan) 2026 <tsujan2000@gmail.com>
+ *
+ * FeatherPad is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FeatherPad is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @license GPL-3.0+ <https://spdx.org/licenses/GPL-3.0+.html>
+ */
+
+#include <QTimer>
+#include "textedit.h"
+#include "highlighter/highlighter.h"
+
+#include <algorithm>
+
+/* Folded blocks are hidden by QTextBlock::setVisible(false). Hidden blocks
+   have no line in the document layout; so, they are neither laid out nor
+   painted, and only the blocks whose visibility changes are marked dirty.
+
+   A foldable region starts after a block with an unclosed brace (or bracket),
+   as recorded by the highlighter, and ends before the block that closes it.
+   With Python and YAML, it consists of the following blocks that are indented
+   more than the header. Since the bracket data is per block and is updated by
+   the highlighter on editing, headers are found without any scan, and the end
+   of a region is searched for only when it is folded. Blocks that aren't
+   highlighted yet are highlighted before their data is used, so that braces
+   inside quotes and comments aren't counted. */
+
+namespace FeatherPad {
+
+// Returns the width of the leading whitespace in columns or -1 if the text is blank.
+static int indentationOf(const QString& text, int tabSize) {
+    int col = 0;
+    for (const QChar& c : text) {
+        if (c == QLatin1Char(' '))
+            ++col;
+        else if (c == QLatin1Char('\t'))
+            col += tabSize - col % tabSize;
+        else
+            return col;
+    }
+    return -1;
+}
+/*************************/
+// Returns the number of braces or brackets that are opened but not closed in the block.
+template <class T>
+static int unclosedCount(const QList<T*>& infos, char open, char close) {
+    int depth = 0;
+    for (const T* info : infos) {
+        if (info->character == open)
+            ++depth;
+        else if (info->character == close && depth > 0)
+            --depth;
+    }
+    return depth;
+}
+/*************************/
+// Changes "depth" by the braces or brackets of the block
+// and returns true if it reaches zero inside the block.
+template <class T>
+static bool closesRegion(const QList<T*>& infos, char open, char close, int& depth) {
+    for (const T* info : infos) {
+        if (info->character == open)
+            ++depth;
+        else if (info->character == close && --depth == 0)
+            return true;
+    }
+    return false;
+}
+/*************************/
+bool TextEdit::indentFolding() const {
+    const QString lang = lang_.isEmpty() ? prog_ : lang_;
+    return lang == "python" || lang == "yaml";
+}
+/*************************/
+bool TextEdit::isFoldHeader(const QTextBlock& block) const {
+    if (!canFold() || !block.isValid())
+        return false;
+    if (indentFolding()) {
+        const int tabSize = std::max(static_cast<int>(textTab_.size()), 1);
+        const int indent = indentationOf(block.text(), tabSize);
+        if (indent < 0)
+            return false;
+        QTextBlock next = block.next();
+        while (next.isValid()) {
+            const int nextIndent = indentationOf(next.text(), tabSize);
+            if (nextIndent > -1)
+                return nextIndent > indent;
+            next = next.next();
+        }
+        return false;
+    }
+    TextBlockData* data = static_cast<TextBlockData*>(block.userData());
+    if (!data)
+        return false;
+    return unclosedCount(data->braces(), '{', '}') > 0 || unclosedCount(data->brackets(), '[', ']') > 0;
+}
+/*************************/
+// Returns the number of the last block that should be hidden
+// if the given block is folded, or -1 if it isn't foldable.
+int TextEdit::foldEnd(const QTextBlock& block) const {
+    if (!canFold() || !block.isValid())
+        return -1;
+
+    if (indentFolding()) {
+        const int tabSize = std::max(static_cast<int>(textTab_.size()), 1);
+        const int indent = indentationOf(block.text(), tabSize);
+        if (indent < 0)
+            return -1;
+        int last = -1;
+        QTextBlock next = block.next();
+        while (next.isValid()) {
+            const int nextIndent = indentationOf(next.text(), tabSize);
+            if (nextIndent > -1) {
+                if (nextIndent <= indent)
+                    break;
+                last = next.blockNumber();  // blank lines at the end aren't folded
+            }
+            next = next.next();
+        }
+        return last;
+    }
+
+    TextBlockData* data = static_cast<TextBlockData*>(block.userData());
+    if (!data)
+        return -1;
+    bool isBrace = true;
+    int depth = unclosedCount(data->braces(), '{', '}');
+    if (depth == 0) {
+        isBrace = false;
+        depth = unclosedCount(data->brackets(), '[', ']');
+        if (depth == 0)
+            return -1;
+    }
+    /* find the block that closes the outermost unclosed brace/bracket */
+    Highlighter* highlighter = qobject_cast<Highlighter*>(highlighter_.data());
+    QTextCursor limitStart, limitEnd;
+    bool limitChanged = false;
+    int last = -1;
+    QTextBlock next = block.next();
+    while (next.isValid()) {
+        data = static_cast<TextBlockData*>(next.userData());
+        if (highlighter && (!data || !data->isHighlighted())) {
+            /* highlight the rest of the region, like with printing */
+            if (!limitChanged) {
+                limitChanged = true;
+                limitStart = highlighter->limitStart();
+                limitEnd = highlighter->limitEnd();
+                QTextCursor end(document());
+                end.movePosition(QTextCursor::End);
+                highlighter->setLimit(QTextCursor(next), end);
+            }
+            highlighter->rehighlightBlock(next);
+            data = static_cast<TextBlockData*>(next.userData());
+        }
+        if (data) {
+            if (isBrace ? closesRegion(data->braces(), '{', '}', depth)
+                        : closesRegion(data->brackets(), '[', ']', depth)) {
+                /* the closing block remains visible */
+                if (next.blockNumber() - 1 > block.blockNumber())
+                    last = next.blockNumber() - 1;
+                break;
+            }
+        }
+        next = next.next();
+    }
+    if (limitChanged)
+        highlighter->setLimit(limitStart, limitEnd);
+    return last;
+}
+/*************************/
+int TextEdit::foldMarginWidth() const {
+    return canFold() ? fontMetrics().height() / 2 + 4 : 0;
+}
+/*************************/
+void TextEdit::setBlocksVisible(const QTextBlock& first, const QTextBlock& last, bool visible) {
+    if (!first.isValid() || !last.isValid() || last.blockNumber() < first.blockNumber())
+        return;
+    QTextBlock block = first;
+    while (block.isValid()) {
+        block.setVisible(visible);
+        if (block == last)
+            break;
+        block = block.next();
+    }
+    /* only the changed blocks are processed by the layout */
+    const int start = first.position();
+    const int end = std::min(last.position() + last.length(), document()->characterCount());
+    document()->markContentsDirty(start, end - start);
+    viewport()->update();
+    lineNumberArea_->update();
+}
+/*************************/
+// Makes the blocks of a region visible again, except for those of the nested folds.
+void TextEdit::restoreFoldedBlocks(const QTextCursor& header, const QTextCursor& last) {
+    const QTextBlock headerBlock = header.block();
+    const QTextBlock lastBlock = last.block();
+    if (lastBlock.blockNumber() <= headerBlock.blockNumber()) {
+        /* the region is removed but its remaining block may be hidden */
+        if (!lastBlock.isVisible())
+            setBlocksVisible(lastBlock, lastBlock, true);
+        return;
+    }
+    setBlocksVisible(headerBlock.next(), lastBlock, true);
+    auto it = folds_.upperBound(headerBlock.blockNumber());
+    const auto end = folds_.upperBound(lastBlock.blockNumber());
+    for (; it != end; ++it)
+        setBlocksVisible(it->header.block().next(), it->last.block(), false);
+}
+/*************************/
+void TextEdit::toggleFold(const QTextBlock& block) {
+    if (!block.isValid())
+        return;
+    auto it = folds_.find(block.blockNumber());
+    if (it != folds_.end()) {
+        const foldRange fold = *it;
+        folds_.erase(it);
+        restoreFoldedBlocks(fold.header, fold.last);
+        if (folds_.isEmpty()) {
+            disconnect(document(), &QTextDocument::contentsChange, this, &TextEdit::onFoldedContentsChange);
+            disconnect(this, &QPlainTextEdit::cursorPositionChanged, this, &TextEdit::keepCursorOutOfFolds);
+        }
+        return;
+    }
+
+    const int end = foldEnd(block);
+    if (end < 0)
+        return;
+    const QTextBlock last = document()->findBlockByNumber(end);
+
+    /* the text cursor shouldn't be inside the region */
+    QTextCursor cur = textCursor();
+    const int n = cur.blockNumber();
+    const int a = document()->findBlock(cur.anchor()).blockNumber();
+    if ((n > block.blockNumber() && n <= end) || (a > block.blockNumber() && a <= end)) {
+        cur.setPosition(block.position() + block.length() - 1);
+        setTextCursor(cur);
+    }
+
+    if (folds_.isEmpty()) {
+        connect(document(), &QTextDocument::contentsChange, this, &TextEdit::onFoldedContentsChange);
+        connect(this, &QPlainTextEdit::cursorPositionChanged, this, &TextEdit::keepCursorOutOfFolds);
+    }
+    foldRange fold;
+    fold.header = QTextCursor(block);
+    fold.last = QTextCursor(last);
+    folds_.insert(block.blockNumber(), fold);
+    foldRevision_ = document()->revision();
+    foldBlockCount_ = document()->blockCount();
+    lastCursorBlock_ = textCursor().blockNumber();
+
+    setBlocksVisible(block.next(), last, false);
+    ensureCursorVisible();
+}
+/*************************/
+void TextEdit::unfoldAll() {
+    if (folds_.isEmpty())
+        return;
+    disconnect(document(), &QTextDocument::contentsChange, this, &TextEdit::onFoldedContentsChange);
+    disconnect(this, &QPlainTextEdit::cursorPositionChanged, this, &TextEdit::keepCursorOutOfFolds);
+    const QList<foldRange> folds = folds_.values();
+    folds_.clear();
+    for (const auto& fold : folds)
+        setBlocksVisible(fold.header.block().next(), fold.last.block(), true);
+}
+/*************************/
+// An edit inside a folded region (by replacement, undo, etc.) unfolds it.
+void TextEdit::onFoldedContentsChange(int position, int charsRemoved, int charsAdded) {
+    /* format changes (by the highlighter) don't change the revision */
+    const int revision = document()->revision();
+    if (charsRemoved == charsAdded && revision == foldRevision_)
+        return;
+    foldRevision_ = revision;
+
+    const int end = position + charsAdded;
+    QList<foldRange> broken;
+    for (auto it = folds_.begin(); it != folds_.end();) {
+        const QTextBlock header = it->header.block();
+        const QTextBlock last = it->last.block();
+        if (last.blockNumber() > header.blockNumber()) {
+            const int hiddenStart = header.position() + header.length();
+            const int hiddenEnd = last.position() + last.length() - 1;
+            if (position > hiddenEnd || end < hiddenStart) {
+                ++it;
+                continue;
+            }
+        }
+        broken << *it;
+        it = folds_.erase(it);
+    }
+
+    /* the numbers of the header blocks may have changed */
+    const int blockCount = document()->blockCount();
+    if (blockCount != foldBlockCount_) {
+        foldBlockCount_ = blockCount;
+        const QList<foldRange> folds = folds_.values();
+        folds_.clear();
+        for (const auto& fold : folds) {
+            const int n = fold.header.blockNumber();
+            if (folds_.contains(n))
+                broken << fold;  // merged headers
+            else
+                folds_.insert(n, fold);
+        }
+    }
+
+    if (broken.isEmpty())
+        return;
+    if (folds_.isEmpty()) {
+        disconnect(document(), &QTextDocument::contentsChange, this, &TextEdit::onFoldedContentsChange);
+        disconnect(this, &QPlainTextEdit::cursorPositionChanged, this, &TextEdit::keepCursorOutOfFolds);
+    }
+    /* wait until the document's layout manager is notified about the change */
+    QTimer::singleShot(0, this, [this, broken] {
+        for (const auto& fold : broken)
+            restoreFoldedBlocks(fold.header, fold.last);
+    });
+}
+/*************************/
+// Skips a folded region when the cursor enters it from a neighboring
+// block (as with Up/Down keys), and unfolds it otherwise (as with finding).
+void TextEdit::keepCursorOutOfFolds() {
+    QTextCursor cur = textCursor();
+    auto outermost = folds_.end();
+    while (true) {
+        const int n = cur.blockNumber();
+        /* the keys are in ascending order; so, the first region containing the block is the outermost one */
+        outermost = folds_.end();
+        const auto end = folds_.lowerBound(n);
+        for (auto it = folds_.begin(); it != end; ++it) {
+            if (n <= it->last.blockNumber()) {
+                outermost = it;
+                break;
+            }
+        }
+        if (outermost == folds_.end() || lastCursorBlock_ == outermost.key()
+            || lastCursorBlock_ == outermost->last.blockNumber() + 1) {
+            break;
+        }
+        const foldRange fold = *outermost;
+        folds_.erase(outermost);
+        restoreFoldedBlocks(fold.header, fold.last);
+    }
+
+    if (outermost != folds_.end()) {
+        const QTextBlock header = outermost->header.block();
+        const QTextBlock after = outermost->last.block().next();
+        const QTextCursor::MoveMode mode = cur.hasSelection() ? QTextCursor::KeepAnchor : QTextCursor::MoveAnchor;
+        if (lastCursorBlock_ == header.blockNumber() && after.isValid())
+            cur.setPosition(after.position(), mode);
+        else
+            cur.setPosition(header.position() + header.length() - 1, mode);
+        setTextCursor(cur);
+    }
+    else if (folds_.isEmpty()) {
+        disconnect(document(), &QTextDocument::contentsChange, this, &TextEdit::onFoldedContentsChange);
+        disconnect(this, &QPlainTextEdit::cursorPositionChanged, this, &TextEdit::keepCursorOutOfFolds);
+    }
+
+    lastCursorBlock_ = textCursor().blockNumber();
+}
+
+}  // namespace FeatherPad
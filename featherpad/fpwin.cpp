@@ -33,6 +33,9 @@
 #include "warningbar.h"
 #include "menubartitle.h"
 #include "svgicons.h"
+#include "outline.h"
+#include "scriptConsole.h"
+#include "hexview.h"
 
 #include <QMimeDatabase>
 #include <QPrintDialog>
@@ -47,12 +50,14 @@
 #include <QProcess>
 #include <QTextDocumentWriter>
 #include <QFileInfo>
+#include <QSet>
 #include <QStandardPaths>
 #include <QDesktopServices>
 #include <QPushButton>
 #include <QDBusConnection>  // for opening containing folder
 #include <QDBusMessage>     // for opening containing folder
 #include <QStringDecoder>
+#include <QThread>
 
 #ifdef HAS_X11
 #include "x11.h"
@@ -62,12 +67,27 @@
 
 namespace FeatherPad {
 
+/* Deletes the documents of closed pages one by one, when the event loop
+   is idle, because freeing a huge document (with its blocks, layouts and
+   undo stack) may take a while. They aren't deleted in another thread
+   because their text layouts use the font caches of the GUI thread.
+   The documents should have no parent and no connection. */
+static void deleteDocsLater(const QList<QTextDocument*>& docs) {
+    QTimer::singleShot(0, qApp, [docs] {
+        QList<QTextDocument*> rest = docs;
+        delete rest.takeLast();
+        if (!rest.isEmpty())
+            deleteDocsLater(rest);
+    });
+}
+
 FPwin::FPwin(QWidget* parent) : QMainWindow(parent), dummyWidget(nullptr), ui(new Ui::FPwin) {
     ui->setupUi(this);
 
     locked_ = false;
     shownBefore_ = false;
     closePreviousPages_ = false;
+    bulkClosing_ = false;
     loadingProcesses_ = 0;
     rightClicked_ = -1;
 
@@ -76,6 +96,11 @@ FPwin::FPwin(QWidget* parent) : QMainWindow(parent), dummyWidget(nullptr), ui(ne
     inactiveTabModified_ = false;
 
     sidePane_ = nullptr;
+    outlineDock_ = nullptr;
+    outline_ = nullptr;
+
+    fileWatcher_ = new QFileSystemWatcher(this);
+    connect(fileWatcher_, &QFileSystemWatcher::fileChanged, this, &FPwin::onWatchedFileChanged);
 
     /* "Jump to" bar */
     ui->spinBox->hide();
@@ -83,11 +108,8 @@ FPwin::FPwin(QWidget* parent) : QMainWindow(parent), dummyWidget(nullptr), ui(ne
     ui->checkBox->hide();
 
     /* status bar */
-    QLabel* statusLabel = new QLabel();
-    statusLabel->setObjectName("statusLabel");
-    statusLabel->setIndent(2);
-    statusLabel->setMinimumWidth(100);
-    statusLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    statusInfo_ = new StatusInfo();
+    statusInfo_->setMinimumWidth(100);
     QToolButton* wordButton = new QToolButton();
     wordButton->setObjectName("wordButton");
     wordButton->setFocusPolicy(Qt::NoFocus);
@@ -97,7 +119,7 @@ FPwin::FPwin(QWidget* parent) : QMainWindow(parent), dummyWidget(nullptr), ui(ne
     wordButton->setIcon(symbolicIcon::icon(":icons/view-refresh.svg"));
     wordButton->setToolTip("<p style='white-space:pre'>" + tr("Calculate number of words") + "</p>");
     connect(wordButton, &QAbstractButton::clicked, [this] { updateWordInfo(); });
-    ui->statusBar->addWidget(statusLabel);
+    ui->statusBar->addWidget(statusInfo_);
     ui->statusBar->addWidget(wordButton);
 
     /* text unlocking */
@@ -163,6 +185,12 @@ FPwin::FPwin(QWidget* parent) : QMainWindow(parent), dummyWidget(nullptr), ui(ne
     ui->actionUTF_8->setActionGroup(aGroup_);
     ui->actionUTF_16->setActionGroup(aGroup_);
     ui->actionISO_8859_1->setActionGroup(aGroup_);
+    for (const QString& encoding : legacyEncodings()) {
+        QAction* action = new QAction(encoding, aGroup_);
+        action->setCheckable(true);
+        action->setData(encoding);
+        ui->menuEncoding->insertAction(ui->actionOther, action);
+    }
     ui->actionOther->setActionGroup(aGroup_);
 
     ui->actionUTF_8->setChecked(true);
@@ -223,6 +251,8 @@ FPwin::FPwin(QWidget* parent) : QMainWindow(parent), dummyWidget(nullptr), ui(ne
 
     connect(ui->tabWidget, &QTabWidget::currentChanged, this, &FPwin::onTabChanged);
     connect(ui->tabWidget, &TabWidget::currentTabChanged, this, &FPwin::tabSwitch);
+    /* apply the preferences that have changed while the new tab was hidden (before it's painted) */
+    connect(ui->tabWidget, &QTabWidget::currentChanged, this, &FPwin::applyPrefsToCurrentTab);
     connect(ui->tabWidget, &TabWidget::hasLastActiveTab,
             [this](bool hasLastActive) { ui->actionLastActiveTab->setEnabled(hasLastActive); });
 
@@ -274,6 +304,7 @@ FPwin::FPwin(QWidget* parent) : QMainWindow(parent), dummyWidget(nullptr), ui(ne
     });
     ui->actionSidePane->setAutoRepeat(false);  // don't let UI change too rapidly
     connect(ui->actionSidePane, &QAction::triggered, [this] { toggleSidePane(); });
+    connect(ui->actionOutline, &QAction::triggered, this, &FPwin::toggleOutline);
 
     /***************************************************************************
      *****     KDE (KAcceleratorManager) has a nasty "feature" that        *****
@@ -810,14 +841,11 @@ void FPwin::applyConfigOnStarting() {
 }
 /*************************/
 void FPwin::addCursorPosLabel() {
-    if (ui->statusBar->findChild<QLabel*>("posLabel"))
+    if (posSegment_)
         return;
-    QLabel* posLabel = new QLabel();
-    posLabel->setObjectName("posLabel");
-    posLabel->setText("<b>" + tr("Position:") + "</b>");
-    posLabel->setIndent(2);
-    posLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
-    ui->statusBar->addPermanentWidget(posLabel);
+    posSegment_ = new StatusSegment(tr("Position:"));
+    posSegment_->setObjectName("posLabel");
+    ui->statusBar->addPermanentWidget(posSegment_);
 }
 /*************************/
 void FPwin::addRemoveLangBtn(bool add) {
@@ -1000,6 +1028,20 @@ void FPwin::deleteTabPage(int tabIndex, bool saveToList, bool closeWithLastTab)
         if (saveToList && config.getSaveLastFilesList() && QFile::exists(fileName))
             lastWinFilesCur_.insert(fileName, textEdit->textCursor().position());
     }
+    if (bulkClosing_) {
+        /* Instead of removing the highlighting, which changes the text, detach
+           the document with its highlighter and delete it later, in idle time. */
+        QTextDocument* doc = textEdit->document();
+        disconnect(textEdit, nullptr, this, nullptr);
+        disconnect(doc, nullptr, nullptr, nullptr);
+        doc->setParent(nullptr);
+        ui->tabWidget->removeTab(tabIndex);
+        delete tabPage;
+        closedDocs_ << doc;
+        if (closeWithLastTab && config.getCloseWithLastTab() && ui->tabWidget->count() == 0)
+            close();
+        return;
+    }
     /* because deleting the syntax highlighter changes the text,
        it is better to disconnect contentsChange() here to prevent a crash */
     disconnect(textEdit, &QPlainTextEdit::textChanged, this, &FPwin::hlight);
@@ -1010,6 +1052,7 @@ void FPwin::deleteTabPage(int tabIndex, bool saveToList, bool closeWithLastTab)
     ui->tabWidget->removeTab(tabIndex);
     delete tabPage;
     tabPage = nullptr;
+    unwatchClosedFiles();
     if (closeWithLastTab && config.getCloseWithLastTab() && ui->tabWidget->count() == 0)
         close();
 }
@@ -1027,6 +1070,7 @@ bool FPwin::closePages(int first, int last, bool saveFilesList) {
     }
 
     pauseAutoSaving(true);
+    bulkClosing_ = true;
 
     bool hasSideList(sidePane_ && !sideItems_.isEmpty());
     TabPage* curPage = nullptr;
@@ -1141,6 +1185,7 @@ bool FPwin::closePages(int first, int last, bool saveFilesList) {
                         else if (count == 1)  // always true
                             updateGUIForSingleTab(true);
                     }
+                    finishBulkClose();
                     unbusy();
                     pauseAutoSaving(false);
                     return false;
@@ -1159,15 +1204,33 @@ bool FPwin::closePages(int first, int last, bool saveFilesList) {
             sidePane_->listWidget()->setCurrentItem(curItem);
         if (closePreviousPages_) {  // continue closing previous pages
             closePreviousPages_ = false;
+            finishBulkClose();
             return closePages(-1, first);
         }
     }
+    finishBulkClose();
 
     pauseAutoSaving(false);
 
     return keep;
 }
 /*************************/
+// While several pages are being closed, the handlers of tab switching are
+// suspended and the documents of the closed pages are kept for deletion.
+// Here, they are deleted in another thread and the current tab is updated.
+void FPwin::finishBulkClose() {
+    if (!bulkClosing_)
+        return;
+    bulkClosing_ = false;
+    if (!closedDocs_.isEmpty()) {
+        deleteDocsLater(closedDocs_);
+        closedDocs_.clear();
+    }
+    unwatchClosedFiles();
+    onTabChanged(ui->tabWidget->currentIndex());
+    applyPrefsToCurrentTab();
+}
+/*************************/
 void FPwin::copyTabFileName() {
     if (rightClicked_ < 0)
         return;
@@ -1295,6 +1358,10 @@ FPwin::DOCSTATE FPwin::savePrompt(int tabIndex,
                     sideItems_.key(tabPage));  // sets the current widget at changeTab()
             else
                 ui->tabWidget->setCurrentIndex(tabIndex);
+            if (bulkClosing_) {  // the handlers of tab switching are suspended
+                onTabChanged(tabIndex);
+                applyPrefsToCurrentTab();
+            }
         }
 
         updateShortcuts(true);
@@ -1367,6 +1434,9 @@ void FPwin::enableWidgets(bool enable) const {
     ui->actionSelectAll->setEnabled(enable);
     ui->actionFind->setEnabled(enable);
     ui->actionJump->setEnabled(enable);
+    ui->actionOutline->setEnabled(enable);
+    if (!enable && outlineDock_ && outlineDock_->isVisible())
+        outlineDock_->setVisible(false);
     ui->actionReplace->setEnabled(enable);
     ui->actionClose->setEnabled(enable);
     ui->actionSaveAs->setEnabled(enable);
@@ -1460,7 +1530,7 @@ void FPwin::newTab() {
 /*************************/
 TabPage* FPwin::createEmptyTab(bool setCurrent, bool allowNormalHighlighter) {
     FPsingleton* singleton = static_cast<FPsingleton*>(qApp);
-    Config config = singleton->getConfig();
+    const Config& config = singleton->getConfig();
 
     static const QList<QKeySequence> searchShortcuts = {QKeySequence(Qt::Key_F3), QKeySequence(Qt::Key_F4),
                                                         QKeySequence(Qt::Key_F5), QKeySequence(Qt::Key_F6),
@@ -1471,17 +1541,12 @@ TabPage* FPwin::createEmptyTab(bool setCurrent, bool allowNormalHighlighter) {
     tabPage->setSearchModel(singleton->searchModel());
     TextEdit* textEdit = tabPage->textEdit();
     connect(textEdit, &QWidget::customContextMenuRequested, this, &FPwin::editorContextMenu);
-    textEdit->setSelectionHighlighting(config.getSelectionHighlighting());
-    textEdit->setPastePaths(config.getPastePaths());
-    textEdit->setAutoReplace(config.getAutoReplace());
-    textEdit->setAutoBracket(config.getAutoBracket());
+    applyPrefs(tabPage);
     textEdit->setTtextTab(config.getTextTabSize());
+    textEdit->setUndoMemoryLimit(config.getUndoMemoryLimit());
     textEdit->setCurLineHighlight(config.getCurLineHighlight());
     textEdit->setEditorFont(config.getFont());
     textEdit->setInertialScrolling(config.getInertialScrolling());
-    textEdit->setDateFormat(config.getDateFormat());
-    if (config.getThickCursor())
-        textEdit->setThickCursor(true);
     if (config.getTextMargin()) {
         textEdit->document()->setDocumentMargin(12);
         textEdit->document()->setModified(false);
@@ -1523,7 +1588,7 @@ TabPage* FPwin::createEmptyTab(bool setCurrent, bool allowNormalHighlighter) {
         connect(textEdit, &QPlainTextEdit::blockCountChanged, this, &FPwin::statusMsgWithLineCount);
         connect(textEdit, &TextEdit::selChanged, this, &FPwin::statusMsg);
         if (config.getShowCursorPos())
-            connect(textEdit, &QPlainTextEdit::cursorPositionChanged, this, &FPwin::showCursorPos);
+            connect(textEdit, &TextEdit::cursorMoved, this, &FPwin::showCursorPos);
     }
     connect(textEdit->document(), &QTextDocument::undoAvailable, ui->actionUndo, &QAction::setEnabled);
     connect(textEdit->document(), &QTextDocument::redoAvailable, ui->actionRedo, &QAction::setEnabled);
@@ -1540,6 +1605,7 @@ TabPage* FPwin::createEmptyTab(bool setCurrent, bool allowNormalHighlighter) {
     connect(textEdit, &TextEdit::filePasted, this, &FPwin::newTabFromName);
     connect(textEdit, &TextEdit::zoomedOut, this, &FPwin::reformat);
     connect(textEdit, &TextEdit::hugeColumn, this, &FPwin::columnWarning);
+    connect(textEdit, &TextEdit::pasting, this, &FPwin::pauseAutoSaving);
 
     connect(tabPage, &TabPage::find, this, &FPwin::find);
     connect(tabPage, &TabPage::searchFlagChanged, this, &FPwin::searchFlagChanged);
@@ -1673,6 +1739,17 @@ void FPwin::editorContextMenu(const QPoint& p) {
         }
         menu->addSeparator();
     }
+    if (textEdit->canFold()) {
+        const QTextBlock block = textEdit->textCursor().block();
+        const bool folded = textEdit->isFolded(block);
+        QAction* foldAction = menu->addAction(folded ? tr("Unfold") : tr("Fold"));
+        foldAction->setEnabled(folded || textEdit->isFoldHeader(block));
+        connect(foldAction, &QAction::triggered, textEdit, [textEdit, block] { textEdit->toggleFold(block); });
+        QAction* unfoldAllAction = menu->addAction(tr("Unfold All"));
+        unfoldAllAction->setEnabled(textEdit->hasFolds());
+        connect(unfoldAllAction, &QAction::triggered, textEdit, &TextEdit::unfoldAll);
+        menu->addSeparator();
+    }
     if (!textEdit->isReadOnly()) {
         menu->addAction(ui->actionSoftTab);
         menu->addSeparator();
@@ -1709,7 +1786,7 @@ void FPwin::editorContextMenu(const QPoint& p) {
 }
 /*************************/
 void FPwin::updateRecenMenu() {
-    Config config = static_cast<FPsingleton*>(qApp)->getConfig();
+    const Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
     QStringList recentFiles = config.getRecentFiles();
     int recentSize = recentFiles.count();
     int recentNumber = config.getCurRecentFilesNumber();
@@ -1833,7 +1910,7 @@ void FPwin::focusSidePane() {
         if (sizes.size() == 2 && sizes.at(0) == 0)  // with RTL too
         {                                           // first, ensure its visibility (see toggleSidePane())
             sizes.clear();
-            Config config = static_cast<FPsingleton*>(qApp)->getConfig();
+            const Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
             if (config.getRemSplitterPos()) {
                 sizes.append(std::min(std::max(16, config.getSplitterPos()), size().width() / 2));
                 sizes.append(100);
@@ -1856,7 +1933,7 @@ void FPwin::executeProcess() {
     }
     closeWarningBar();
 
-    Config config = static_cast<FPsingleton*>(qApp)->getConfig();
+    const Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
     if (!config.getExecuteScripts())
         return;
 
@@ -1875,9 +1952,17 @@ void FPwin::executeProcess() {
         }
 
         QProcess* process = new QProcess(tabPage);
-        process->setObjectName(fName);  // to put it into the message dialog
-        connect(process, &QProcess::readyReadStandardOutput, this, &FPwin::displayOutput);
-        connect(process, &QProcess::readyReadStandardError, this, &FPwin::displayError);
+        /* the console is created on the first output and reads the process directly;
+           if it's closed while the process is running, a new one is created on demand */
+        auto showConsole = [this, process, tabPage, fName] {
+            if (tabPage->findChild<ScriptConsole*>(QString(), Qt::FindDirectChildrenOnly))
+                return;
+            ScriptConsole* console = new ScriptConsole(process, fName, tabPage);
+            console->show();
+            stealFocus(console);
+        };
+        connect(process, &QProcess::readyReadStandardOutput, this, showConsole);
+        connect(process, &QProcess::readyReadStandardError, this, showConsole);
         QString command = config.getExecuteCommand();
         if (!command.isEmpty()) {
             QStringList commandParts = QProcess::splitCommand(command);
@@ -1908,80 +1993,6 @@ void FPwin::exitProcess() {
     }
 }
 /*************************/
-void FPwin::displayMessage(bool error) {
-    QProcess* process = static_cast<QProcess*>(QObject::sender());
-    if (!process)
-        return;  // impossible
-    QByteArray msg;
-    if (error) {
-        process->setReadChannel(QProcess::StandardError);
-        msg = process->readAllStandardError();
-    }
-    else {
-        process->setReadChannel(QProcess::StandardOutput);
-        msg = process->readAllStandardOutput();
-    }
-    if (msg.isEmpty())
-        return;
-
-    QPointer<QDialog> msgDlg = nullptr;
-    QList<QDialog*> dialogs = findChildren<QDialog*>();
-    for (int i = 0; i < dialogs.count(); ++i) {
-        if (dialogs.at(i)->parent() == process->parent()) {
-            msgDlg = dialogs.at(i);
-            break;
-        }
-    }
-    if (msgDlg) {  // append to the existing message
-        if (QPlainTextEdit* tEdit = msgDlg->findChild<QPlainTextEdit*>()) {
-            tEdit->setPlainText(tEdit->toPlainText() + "\n" + msg.constData());
-            QTextCursor cur = tEdit->textCursor();
-            cur.movePosition(QTextCursor::End);
-            tEdit->setTextCursor(cur);
-            stealFocus(msgDlg);
-        }
-    }
-    else {
-        msgDlg = new QDialog(qobject_cast<QWidget*>(process->parent()));
-        msgDlg->setWindowTitle(tr("Script Output"));
-        msgDlg->setSizeGripEnabled(true);
-        QGridLayout* grid = new QGridLayout;
-        QLabel* label = new QLabel(msgDlg);
-        label->setText("<center><b>" + tr("Script File") + ": </b></center><i>" + process->objectName() + "</i>");
-        label->setTextInteractionFlags(Qt::TextSelectableByMouse);
-        label->setWordWrap(true);
-        label->setMargin(5);
-        grid->addWidget(label, 0, 0, 1, 2);
-        QPlainTextEdit* tEdit = new QPlainTextEdit(msgDlg);
-        tEdit->setTextInteractionFlags(Qt::TextSelectableByMouse);
-        tEdit->ensureCursorVisible();
-        grid->addWidget(tEdit, 1, 0, 1, 2);
-        QPushButton* closeButton = new QPushButton(QIcon::fromTheme("edit-delete"), tr("Close"));
-        connect(closeButton, &QAbstractButton::clicked, msgDlg, &QDialog::reject);
-        grid->addWidget(closeButton, 2, 1, Qt::AlignRight);
-        QPushButton* clearButton = new QPushButton(QIcon::fromTheme("edit-clear"), tr("Clear"));
-        connect(clearButton, &QAbstractButton::clicked, tEdit, &QPlainTextEdit::clear);
-        grid->addWidget(clearButton, 2, 0, Qt::AlignLeft);
-        msgDlg->setLayout(grid);
-        tEdit->setPlainText(msg.constData());
-        QTextCursor cur = tEdit->textCursor();
-        cur.movePosition(QTextCursor::End);
-        tEdit->setTextCursor(cur);
-        msgDlg->setAttribute(Qt::WA_DeleteOnClose);
-        msgDlg->show();
-        msgDlg->raise();
-        msgDlg->activateWindow();
-    }
-}
-/*************************/
-void FPwin::displayOutput() {
-    displayMessage(false);
-}
-/*************************/
-void FPwin::displayError() {
-    displayMessage(true);
-}
-/*************************/
 // This closes either the current page or the right-clicked side-pane item but
 // never the right-clicked tab because the tab context menu has no closing item.
 void FPwin::closePage() {
@@ -2203,14 +2214,18 @@ void FPwin::loadText(const QString& fileName,
                      int restoreCursor,
                      int posInLine,
                      bool enforceUneditable,
-                     bool multiple) {
+                     bool multiple,
+                     const QByteArray& rawBytes) {
     ++loadingProcesses_;
     QString charset;
     if (enforceEncod)
         charset = checkToEncoding();
     Loading* thread = new Loading(fileName, charset, reload, restoreCursor, posInLine, enforceUneditable, multiple);
     thread->setSkipNonText(static_cast<FPsingleton*>(qApp)->getConfig().getSkipNonText());
+    if (enforceEncod)
+        thread->setRawBytes(rawBytes);
     connect(thread, &Loading::completed, this, &FPwin::addText);
+    connect(thread, &Loading::nonTextSkipped, this, [this](const QString& fname) { skippedNonText_ << fname; });
     connect(thread, &Loading::finished, thread, &QObject::deleteLater);
     thread->start();
 
@@ -2370,6 +2385,9 @@ void FPwin::addText(const QString& text,
     textEdit->setFileName(fileName);
     textEdit->setSize(fInfo.size());
     textEdit->setLastModified(fInfo.lastModified());
+    watchFile(tabPage, fInfo);
+    if (Loading* loader = qobject_cast<Loading*>(QObject::sender()))
+        tabPage->setRawBytes(loader->rawBytes(), fInfo.lastModified());
     lastFile_ = fileName;
     if (config.getRecentOpened())
         addRecentFile(lastFile_);
@@ -2383,6 +2401,8 @@ void FPwin::addText(const QString& text,
     setProgLang(textEdit);
     if (ui->actionSyntax->isChecked())
         syntaxHighlighting(textEdit);
+    if (outline_)
+        outline_->refresh();  // the language may have changed
     setTitle(fileName, (multiple && !openInCurrentTab)
                            ?
                            /* An Old comment not valid anymore: "The index may have changed because syntaxHighlighting()
@@ -2530,14 +2550,27 @@ void FPwin::onOpeningHugeFiles() {
 /*************************/
 void FPwin::onOpeninNonTextFiles() {
     disconnect(this, &FPwin::finishedLoading, this, &FPwin::onOpeninNonTextFiles);
+    const QStringList skipped = skippedNonText_;
+    skippedNonText_.clear();
     QTimer::singleShot(0, this, [=]() {
         showWarningBar("<center><b><big>" + tr("Non-text file(s) not opened!") + "</big></b></center>\n" +
                            "<center><i>" + tr("See Preferences → Files → Do not permit opening of non-text files") +
                            "</i></center>",
                        20);
+        /* a single skipped file can still be inspected, but
+           a viewer for each file of a multiple opening would be a nuisance */
+        if (skipped.size() == 1)
+            showHexView(skipped.first());
     });
 }
 /*************************/
+void FPwin::showHexView(const QString& fileName) {
+    HexViewer* viewer = new HexViewer(fileName, this);
+    viewer->show();
+    viewer->raise();
+    viewer->activateWindow();
+}
+/*************************/
 void FPwin::onPermissionDenied() {
     disconnect(this, &FPwin::finishedLoading, this, &FPwin::onPermissionDenied);
     QTimer::singleShot(0, this, [=]() {
@@ -2568,6 +2601,82 @@ void FPwin::onOpeningNonexistent() {
     });
 }
 /*************************/
+// Caches the state of the file of a page and watches it for later changes.
+// A missing file is checked again on switching to its page or activating the window.
+void FPwin::watchFile(TabPage* tabPage, const QFileInfo& info) {
+    updateFileState(tabPage, info);
+    if (tabPage->fileState() != TabPage::FileMissing) {
+        const QString path = info.absoluteFilePath();
+        if (!fileWatcher_->files().contains(path))
+            fileWatcher_->addPath(path);
+    }
+}
+/*************************/
+// Stops watching the files that no page of this window has anymore
+// (because their pages are closed, detached or saved under other names).
+void FPwin::unwatchClosedFiles() {
+    const QStringList watched = fileWatcher_->files();
+    if (watched.isEmpty())
+        return;
+    QSet<QString> paths;
+    for (int i = 0; i < ui->tabWidget->count(); ++i) {
+        TabPage* tabPage = qobject_cast<TabPage*>(ui->tabWidget->widget(i));
+        const QString fname = tabPage->textEdit()->getFileName();
+        if (!fname.isEmpty())
+            paths.insert(QFileInfo(fname).absoluteFilePath());
+    }
+    QStringList closed;
+    for (const auto& path : watched) {
+        if (!paths.contains(path))
+            closed << path;
+    }
+    if (!closed.isEmpty())
+        fileWatcher_->removePaths(closed);
+}
+/*************************/
+void FPwin::updateFileState(TabPage* tabPage, const QFileInfo& info) const {
+    if (!info.exists()) {
+        tabPage->setFileState(TabPage::FileMissing);
+        tabPage->setExecutable(false);
+    }
+    else {
+        tabPage->setFileState(tabPage->textEdit()->getLastModified() != info.lastModified() ? TabPage::FileChanged
+                                                                                           : TabPage::FileUnchanged);
+        tabPage->setExecutable(info.isExecutable());
+    }
+}
+/*************************/
+void FPwin::warnAboutFileState(TabPage* tabPage) {
+    if (tabPage->fileState() == TabPage::FileMissing)
+        onOpeningNonexistent();
+    else if (tabPage->fileState() == TabPage::FileChanged)
+        showWarningBar("<center><b><big>" + tr("This file has been modified elsewhere or in another way!") +
+                           "</big></b></center>\n" + "<center>" +
+                           tr("Please be careful about reloading or saving this document!") + "</center>",
+                       15);
+}
+/*************************/
+// Called when a watched file is changed, removed or replaced. The file is checked only
+// here, and the states of its pages are updated, to be used when they are switched to.
+void FPwin::onWatchedFileChanged(const QString& path) {
+    QFileInfo info(path);
+    bool found = false;
+    for (int i = 0; i < ui->tabWidget->count(); ++i) {
+        TabPage* tabPage = qobject_cast<TabPage*>(ui->tabWidget->widget(i));
+        const QString fname = tabPage->textEdit()->getFileName();
+        if (fname.isEmpty() || QFileInfo(fname).absoluteFilePath() != path)
+            continue;
+        found = true;
+        updateFileState(tabPage, info);
+    }
+    if (!found)  // the pages of this file are closed or saved elsewhere
+        fileWatcher_->removePath(path);
+    else if (info.exists() && !fileWatcher_->files().contains(path)) {
+        /* the file is replaced (e.g., saved by another app through renaming) */
+        fileWatcher_->addPath(path);
+    }
+}
+/*************************/
 void FPwin::columnWarning() {
     showWarningBar("<center><b><big>" + tr("Huge column!") + "</big></b></center>\n" + "<center>" +
                    tr("Columns with more than 1000 rows are not supported.") + "</center>");
@@ -2753,28 +2862,25 @@ void FPwin::enforceEncoding(QAction* a) {
                 encodingToCheck(textEdit->getEncoding());
             return;
         }
+        /* if the file hasn't changed since it was loaded, just re-decode its cached bytes */
+        QByteArray rawBytes;
+        if (tabPage->fileState() == TabPage::FileUnchanged && tabPage->rawBytesTime() == textEdit->getLastModified())
+            rawBytes = tabPage->rawBytes();
         /* if the file is removed, close its tab to open a new one */
-        if (!QFile::exists(fname))
+        if (!QFile::exists(fname)) {
+            rawBytes.clear();
             deleteTabPage(index, false, false);
+        }
 
         a->setChecked(true);  // the checked action might have been changed (to UTF-8) with saving
-        loadText(fname, true, true, 0, 0, textEdit->isUneditable(), false);
+        loadText(fname, true, true, 0, 0, textEdit->isUneditable(), false, rawBytes);
     }
     else {
         /* just change the statusbar text; the doc
            might be saved later with the new encoding */
         textEdit->setEncoding(checkToEncoding());
         if (ui->statusBar->isVisible()) {
-            QLabel* statusLabel = ui->statusBar->findChild<QLabel*>("statusLabel");
-            QString str = statusLabel->text();
-            QString encodStr = tr("Encoding");
-            // the next info is about lines; there's no syntax info
-            QString lineStr = "</i>&nbsp;&nbsp;&nbsp;<b>" + tr("Lines");
-            int i = str.indexOf(encodStr);
-            int j = str.indexOf(lineStr);
-            int offset = encodStr.size() + 9;  // size of ":</b> <i>"
-            str.replace(i + offset, j - i - offset, checkToEncoding());
-            statusLabel->setText(str);
+            statusInfo_->setEncoding(checkToEncoding());
         }
     }
 }
@@ -2811,6 +2917,29 @@ static inline int trailingSpaces(const QString& str) {
     return i;
 }
 
+// Returns the text of the document without its trailing spaces.
+// With "doubleSpace" (Markdown), two trailing spaces are kept as a line break;
+// with "singleSpace" (LaTeX), a single trailing space is kept.
+static QString textWithoutTrailingSpaces(const QTextDocument* doc, bool doubleSpace, bool singleSpace) {
+    QString res;
+    QTextBlock block = doc->firstBlock();
+    while (block.isValid()) {
+        const QString text = block.text();
+        int num = trailingSpaces(text);
+        if (num > 0) {
+            if (doubleSpace)
+                num = num == 2 ? 0 : std::max(1, num - 2);
+            else if (singleSpace)
+                num = num > 1 ? num - 1 : 0;
+        }
+        res += num > 0 ? text.left(text.length() - num) : text;
+        block = block.next();
+        if (block.isValid())
+            res += QChar(QChar::ParagraphSeparator);
+    }
+    return res;
+}
+
 void FPwin::removeTrailingSpacesIfNeeded(TextEdit* textEdit) {
     QString lang = textEdit->getFileName().isEmpty() ? textEdit->getLang() : textEdit->getProg();
 
@@ -2820,48 +2949,15 @@ void FPwin::removeTrailingSpacesIfNeeded(TextEdit* textEdit) {
     }
 
     makeBusy();
-    // same block iteration as before
-    QTextBlock block = textEdit->document()->firstBlock();
-    QTextCursor tmpCur = textEdit->textCursor();
-    tmpCur.beginEditBlock();
-
     // Check 'doubleSpace' for markdown, 'singleSpace' for LaTeX, etc.
     bool doubleSpace = (lang == "markdown" || lang == "fountain");
     bool singleSpace = (lang == "LaTeX");
 
-    while (block.isValid()) {
-        int num = trailingSpaces(block.text());
-        if (num > 0) {
-            tmpCur.setPosition(block.position() + block.text().length());
-            if (doubleSpace) {
-                if (num != 2)
-                    tmpCur.movePosition(QTextCursor::PreviousCharacter, QTextCursor::KeepAnchor, std::max(1, num - 2));
-            }
-            else if (singleSpace) {
-                if (num > 1)
-                    tmpCur.movePosition(QTextCursor::PreviousCharacter, QTextCursor::KeepAnchor, num - 1);
-            }
-            else {
-                tmpCur.movePosition(QTextCursor::PreviousCharacter, QTextCursor::KeepAnchor, num);
-            }
-            tmpCur.removeSelectedText();
-        }
-        block = block.next();
-    }
-    tmpCur.endEditBlock();
+    /* the removal is done as a single edit */
+    QTextDocument* doc = textEdit->document();
+    textEdit->replaceRange(0, doc->characterCount() - 1, textWithoutTrailingSpaces(doc, doubleSpace, singleSpace));
     unbusy();
 }
-
-static inline QStringEncoder getEncoder(const QString& encoding) {
-    if (encoding.compare("UTF-16", Qt::CaseInsensitive) == 0) {
-        return QStringEncoder(QStringConverter::Utf16,
-                              QStringConverter::Flag::WriteBom);  // needed with fwrite()
-    }
-    return QStringEncoder(encoding.compare("UTF-8", Qt::CaseInsensitive) == 0    ? QStringConverter::Utf8
-                          : encoding.compare("UTF-32", Qt::CaseInsensitive) == 0 ?  // not needed
-                              QStringConverter::Utf32
-                                                                                 : QStringConverter::Latin1);
-}
 /*************************/
 bool FPwin::showSaveDialogAndSetFileName(QString& fname, const QString& filter, const QString& title) {
     if (hasAnotherDialog())
@@ -2913,9 +3009,8 @@ bool FPwin::writeFileWithEncoding(const QString& fname, TextEdit* textEdit, bool
 bool FPwin::writeUtf16File(const QString& fname, TextEdit* textEdit) {
     // your logic for writing a UTF-16 file with \r\n endings
     // Example:
-    QStringEncoder encoder = getEncoder("UTF-16");
     QString contents = textEdit->document()->toPlainText().replace("\n", "\r\n");
-    QByteArray encodedString = encoder.encode(contents);
+    QByteArray encodedString = encodeText(contents, "UTF-16");
 
     QFile file(fname);
     if (!file.open(QIODevice::WriteOnly))
@@ -2930,9 +3025,6 @@ bool FPwin::promptAndWriteWithChosenEOL(const QString& fname,
                                         TextEdit* textEdit,
                                         const QString& encoding,
                                         bool& MSWinLineEnd) {
-    // We'll need the encoder for the chosen 'encoding'
-    QStringEncoder encoder = getEncoder(encoding);
-
     // For writing
     bool success = false;
     QByteArray encodedString;
@@ -2989,7 +3081,7 @@ bool FPwin::promptAndWriteWithChosenEOL(const QString& fname,
     }
 
     // Now encode the final contents
-    encodedString = encoder.encode(contents);
+    encodedString = encodeText(contents, encoding);
     txt = encodedString.constData();
 
     // Use a simple ofstream to write the result
@@ -3171,10 +3263,14 @@ bool FPwin::saveFile(bool keepSyntax,
     if (success) {
         QFileInfo fInfo(fname);
 
+        const QString oldName = textEdit->getFileName();
         textEdit->document()->setModified(false);
         textEdit->setFileName(fname);
         textEdit->setSize(fInfo.size());
         textEdit->setLastModified(fInfo.lastModified());
+        watchFile(curPage, fInfo);
+        if (oldName != fname)
+            unwatchClosedFiles();  // saved under another name
         ui->actionReload->setDisabled(false);
         setTitle(fname);
 
@@ -3225,7 +3321,7 @@ void FPwin::reloadSyntaxHighlighter(
     if (prevLan == textEdit->getProg())
         return;
 
-    Config config = static_cast<FPsingleton*>(qApp)->getConfig();
+    const Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
     if (config.getShowLangSelector() && config.getSyntaxByDefault()) {
         if (textEdit->getLang() == textEdit->getProg())
             textEdit->setLang(QString());  // not enforced because it's the real syntax
@@ -3242,36 +3338,8 @@ void FPwin::reloadSyntaxHighlighter(
             syntaxHighlighting(textEdit);
     }
 
-    if (ui->statusBar->isVisible()) {  // correct the statusbar text just by replacing the old syntax info
-        QLabel* statusLabel = ui->statusBar->findChild<QLabel*>("statusLabel");
-        QString str = statusLabel->text();
-        QString syntaxStr = tr("Syntax");
-        int i = str.indexOf(syntaxStr);
-        if (i == -1)  // there was no real language before saving (prevLan was "url")
-        {
-            QString lineStr = "&nbsp;&nbsp;&nbsp;<b>" + tr("Lines");
-            int j = str.indexOf(lineStr);
-            syntaxStr = "&nbsp;&nbsp;&nbsp;<b>" + tr("Syntax") + QString(":</b> <i>%1</i>").arg(textEdit->getProg());
-            str.insert(j, syntaxStr);
-        }
-        else {
-            if (textEdit->getProg() == "url")  // there's no real language after saving
-            {
-                syntaxStr = "&nbsp;&nbsp;&nbsp;<b>" + tr("Syntax");
-                QString lineStr = "&nbsp;&nbsp;&nbsp;<b>" + tr("Lines");
-                int j = str.indexOf(syntaxStr);
-                int k = str.indexOf(lineStr);
-                str.remove(j, k - j);
-            }
-            else  // the language is changed by saving
-            {
-                QString lineStr = "</i>&nbsp;&nbsp;&nbsp;<b>" + tr("Lines");
-                int j = str.indexOf(lineStr);
-                int offset = syntaxStr.size() + 9;  // size of ":</b> <i>"
-                str.replace(i + offset, j - i - offset, textEdit->getProg());
-            }
-        }
-        statusLabel->setText(str);
+    if (ui->statusBar->isVisible()) {  // correct the syntax info of the statusbar
+        statusInfo_->setSyntax(textEdit->getProg() == "url" ? QString() : textEdit->getProg());
         if (textEdit->getWordNumber() != -1)
             connect(textEdit->document(), &QTextDocument::contentsChange, this, &FPwin::updateWordInfo);
     }
@@ -3341,7 +3409,7 @@ void FPwin::toSoftTabs() {
 /*************************/
 void FPwin::insertDate() {
     if (TabPage* tabPage = qobject_cast<TabPage*>(ui->tabWidget->currentWidget())) {
-        Config config = static_cast<FPsingleton*>(qApp)->getConfig();
+        const Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
         QString format = config.getDateFormat();
         tabPage->textEdit()->insertPlainText(format.isEmpty()
                                                  ? locale().toString(QDateTime::currentDateTime(), QLocale::ShortFormat)
@@ -3382,6 +3450,7 @@ void FPwin::startCase() {
     if (TabPage* tabPage = qobject_cast<TabPage*>(ui->tabWidget->currentWidget())) {
         TextEdit* textEdit = tabPage->textEdit();
         if (!textEdit->isReadOnly()) {
+            textEdit->keepSelectionData();
             bool showWarning = false;
             QTextCursor cur = textEdit->textCursor();
             int start = std::min(cur.anchor(), cur.position());
@@ -3502,7 +3571,7 @@ void FPwin::makeEditable() {
     bool hasColumn = !textEdit->getColSel().isEmpty();
 
     textEdit->setReadOnly(false);
-    Config config = static_cast<FPsingleton*>(qApp)->getConfig();
+    const Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
     if (!textEdit->hasDarkScheme()) {
         textEdit->viewport()->setStyleSheet(QString(".QWidget {"
                                                     "color: black;"
@@ -3554,6 +3623,8 @@ void FPwin::changeTab(QListWidgetItem* current) {
 /*************************/
 // Called immediately after changing tab (closes the warningbar if it isn't needed)
 void FPwin::onTabChanged(int index) {
+    if (bulkClosing_)
+        return;
     if (index > -1) {
         QString fname = qobject_cast<TabPage*>(ui->tabWidget->widget(index))->textEdit()->getFileName();
         if (fname.isEmpty() || QFile::exists(fname))
@@ -3563,9 +3634,38 @@ void FPwin::onTabChanged(int index) {
         closeWarningBar();
 }
 /*************************/
+// Applies the preferences that can change while a tab exists. The preferences
+// dialog only applies them to the current tabs; the others are updated when
+// they become current, so that a change doesn't touch all tabs at once.
+void FPwin::applyPrefs(TabPage* tabPage) const {
+    FPsingleton* singleton = static_cast<FPsingleton*>(qApp);
+    const Config& config = singleton->getConfig();
+    TextEdit* textEdit = tabPage->textEdit();
+    if (textEdit->getSelectionHighlighting() != config.getSelectionHighlighting())
+        textEdit->setSelectionHighlighting(config.getSelectionHighlighting());
+    textEdit->setShowOverview(config.getDocumentOverview());
+    textEdit->setPastePaths(config.getPastePaths());
+    textEdit->setAutoReplace(config.getAutoReplace());
+    textEdit->setAutoBracket(config.getAutoBracket());
+    textEdit->setDateFormat(config.getDateFormat());
+    textEdit->setThickCursor(config.getThickCursor());
+    tabPage->setPrefVersion(singleton->prefVersion());
+}
+/*************************/
+void FPwin::applyPrefsToCurrentTab() const {
+    if (bulkClosing_)
+        return;
+    if (TabPage* tabPage = qobject_cast<TabPage*>(ui->tabWidget->currentWidget())) {
+        if (tabPage->prefVersion() != static_cast<FPsingleton*>(qApp)->prefVersion())
+            applyPrefs(tabPage);
+    }
+}
+/*************************/
 // Called with a timeout after tab switching (changes the window title, sets action states, etc.)
 void FPwin::tabSwitch(int index) {
     TabPage* tabPage = qobject_cast<TabPage*>(ui->tabWidget->widget(index));
+    if (outlineDock_ && outlineDock_->isVisible())
+        outline_->setTextEdit(tabPage ? tabPage->textEdit() : nullptr);
     if (tabPage == nullptr) {
         setWindowTitle("FeatherPad[*]");
         if (auto label = qobject_cast<QLabel*>(ui->menuBar->cornerWidget()))
@@ -3577,10 +3677,11 @@ void FPwin::tabSwitch(int index) {
     TextEdit* textEdit = tabPage->textEdit();
     if (!tabPage->isSearchBarVisible() && !sidePane_)
         textEdit->setFocus();
+    /* the states that are kept by the page are only applied */
+    const TabPage::UiState& state = tabPage->uiState();
     QString fname = textEdit->getFileName();
-    bool modified(textEdit->document()->isModified());
+    bool modified(state.modified);
 
-    QFileInfo info;
     QString shownName;
     if (fname.isEmpty()) {
         if (textEdit->getProg() == "help")
@@ -3589,15 +3690,17 @@ void FPwin::tabSwitch(int index) {
             shownName = tr("Untitled");
     }
     else {
-        info.setFile(fname);
-        shownName = (fname.contains("/") ? fname : info.absolutePath() + "/" + fname);
-        if (!QFile::exists(fname))
-            onOpeningNonexistent();
-        else if (textEdit->getLastModified() != info.lastModified())
-            showWarningBar("<center><b><big>" + tr("This file has been modified elsewhere or in another way!") +
-                               "</big></b></center>\n" + "<center>" +
-                               tr("Please be careful about reloading or saving this document!") + "</center>",
-                           15);
+        if (state.fileName == fname)
+            shownName = state.shownName;
+        else {
+            shownName = (fname.contains("/") ? fname : QFileInfo(fname).absolutePath() + "/" + fname);
+            tabPage->setShownName(fname, shownName);
+        }
+        /* the file state is cached by the file watcher, unless the page comes from another
+           window or its file is missing (a removed file isn't watched but may be restored) */
+        if (tabPage->fileState() == TabPage::FileUnknown || tabPage->fileState() == TabPage::FileMissing)
+            watchFile(tabPage, QFileInfo(fname));
+        warnAboutFileState(tabPage);
     }
     if (modified)
         shownName.prepend("*");
@@ -3607,14 +3710,20 @@ void FPwin::tabSwitch(int index) {
        the replace dock may have been closed, hlight() will be called automatically */
     // if (!textEdit->getSearchedText().isEmpty()) hlight();
 
-    /* correct the encoding menu */
-    encodingToCheck(textEdit->getEncoding());
+    /* correct the encoding menu (the cached action may belong to another window) */
+    const QString encoding = textEdit->getEncoding();
+    QAction* encAction = state.encodingAction;
+    if (encAction == nullptr || encAction->actionGroup() != aGroup_ || state.encoding != encoding) {
+        encAction = encodingAction(encoding);
+        tabPage->setEncodingAction(encoding, encAction);
+    }
+    checkEncodingAction(encAction);
 
-    Config config = static_cast<FPsingleton*>(qApp)->getConfig();
+    const Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
 
     /* correct the states of some buttons */
-    ui->actionUndo->setEnabled(textEdit->document()->isUndoAvailable());
-    ui->actionRedo->setEnabled(textEdit->document()->isRedoAvailable());
+    ui->actionUndo->setEnabled(state.undo);
+    ui->actionRedo->setEnabled(state.redo);
     bool readOnly = textEdit->isReadOnly();
     if (!config.getSaveUnmodified())
         ui->actionSave->setEnabled(modified);
@@ -3635,16 +3744,14 @@ void FPwin::tabSwitch(int index) {
     ui->actionPaste->setEnabled(!readOnly);  // it might change temporarily in showingEditMenu()
     ui->actionSoftTab->setEnabled(!readOnly);
     ui->actionDate->setEnabled(!readOnly);
-    bool textIsSelected = textEdit->textCursor().hasSelection();
-    bool hasColumn = !textEdit->getColSel().isEmpty();
-    ui->actionCopy->setEnabled(textIsSelected || hasColumn);
-    ui->actionCut->setEnabled(!readOnly && (textIsSelected || hasColumn));
-    ui->actionDelete->setEnabled(!readOnly && (textIsSelected || hasColumn));
-    ui->actionUpperCase->setEnabled(!readOnly && textIsSelected);
-    ui->actionLowerCase->setEnabled(!readOnly && textIsSelected);
-    ui->actionStartCase->setEnabled(!readOnly && textIsSelected);
-
-    if (isScriptLang(textEdit->getProg()) && info.isExecutable())
+    ui->actionCopy->setEnabled(state.canCopy);
+    ui->actionCut->setEnabled(!readOnly && state.canCopy);
+    ui->actionDelete->setEnabled(!readOnly && state.canCopy);
+    ui->actionUpperCase->setEnabled(!readOnly && state.textSelected);
+    ui->actionLowerCase->setEnabled(!readOnly && state.textSelected);
+    ui->actionStartCase->setEnabled(!readOnly && state.textSelected);
+
+    if (isScriptLang(textEdit->getProg()) && !fname.isEmpty() && tabPage->isExecutable())
         ui->actionRun->setVisible(config.getExecuteScripts());
     else
         ui->actionRun->setVisible(false);
@@ -3666,9 +3773,6 @@ void FPwin::tabSwitch(int index) {
         else {
             if (wordButton)
                 wordButton->setVisible(false);
-            QLabel* statusLabel = ui->statusBar->findChild<QLabel*>("statusLabel");
-            statusLabel->setText(
-                QString("%1 <i>%2</i>").arg(statusLabel->text(), locale().toString(textEdit->getWordNumber())));
         }
         showCursorPos();
     }
@@ -3774,7 +3878,7 @@ void FPwin::showEvent(QShowEvent* event) {
        the first time, we call setGeometry() inside showEvent(). */
     if (!shownBefore_ && !event->spontaneous()) {
         shownBefore_ = true;
-        Config config = static_cast<FPsingleton*>(qApp)->getConfig();
+        const Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
         if (config.getRemPos() && !static_cast<FPsingleton*>(qApp)->isWayland()) {
             QSize theSize = (config.getRemSize() ? config.getWinSize() : config.getStartSize());
             setGeometry(QRect(config.getWinPos(), theSize));
@@ -3792,21 +3896,15 @@ void FPwin::showEvent(QShowEvent* event) {
 bool FPwin::event(QEvent* event) {
     if (event->type() == QEvent::ActivationChange && isActiveWindow()) {
         if (TabPage* tabPage = qobject_cast<TabPage*>(ui->tabWidget->currentWidget())) {
-            TextEdit* textEdit = tabPage->textEdit();
-            QString fname = textEdit->getFileName();
+            QString fname = tabPage->textEdit()->getFileName();
             if (!fname.isEmpty()) {
-                if (!QFile::exists(fname)) {
-                    if (isLoading())
-                        connect(this, &FPwin::finishedLoading, this, &FPwin::onOpeningNonexistent,
-                                Qt::UniqueConnection);
-                    else
-                        onOpeningNonexistent();
-                }
-                else if (textEdit->getLastModified() != QFileInfo(fname).lastModified())
-                    showWarningBar("<center><b><big>" + tr("This file has been modified elsewhere or in another way!") +
-                                       "</big></b></center>\n" + "<center>" +
-                                       tr("Please be careful about reloading or saving this document!") + "</center>",
-                                   15);
+                /* the file watcher may miss changes (on network mounts, for example);
+                   so, the file is checked again when the window is activated */
+                watchFile(tabPage, QFileInfo(fname));
+                if (tabPage->fileState() == TabPage::FileMissing && isLoading())
+                    connect(this, &FPwin::finishedLoading, this, &FPwin::onOpeningNonexistent, Qt::UniqueConnection);
+                else
+                    warnAboutFileState(tabPage);
             }
         }
     }
@@ -3838,6 +3936,7 @@ void FPwin::showHideSearch() {
             /* ... remove all yellow and green highlights... */
             TextEdit* textEdit = page->textEdit();
             textEdit->setSearchedText(QString());
+            textEdit->setSearchMarkers(QString(), QTextDocument::FindFlags(), false);
             QList<QTextEdit::ExtraSelection> es;
             textEdit->setGreenSel(es);  // not needed
             if (ui->actionLineNumbers->isChecked() || ui->spinBox->isVisible())
@@ -3958,18 +4057,28 @@ void FPwin::toggleIndent() {
 }
 /*************************/
 void FPwin::encodingToCheck(const QString& encoding) {
-    ui->actionOther->setDisabled(true);
-
+    checkEncodingAction(encodingAction(encoding));
+}
+/*************************/
+// Returns the action of the encoding in the encoding menu ("Other" if it isn't listed).
+QAction* FPwin::encodingAction(const QString& encoding) const {
     if (encoding == "UTF-8")
-        ui->actionUTF_8->setChecked(true);
-    else if (encoding == "UTF-16")
-        ui->actionUTF_16->setChecked(true);
-    else if (encoding == "ISO-8859-1")
-        ui->actionISO_8859_1->setChecked(true);
-    else {
-        ui->actionOther->setDisabled(false);
-        ui->actionOther->setChecked(true);
+        return ui->actionUTF_8;
+    if (encoding == "UTF-16")
+        return ui->actionUTF_16;
+    if (encoding == "ISO-8859-1")
+        return ui->actionISO_8859_1;
+    const auto actions = aGroup_->actions();
+    for (const auto& action : actions) {
+        if (action->data().toString() == encoding)
+            return action;
     }
+    return ui->actionOther;
+}
+/*************************/
+void FPwin::checkEncodingAction(QAction* action) {
+    ui->actionOther->setEnabled(action == ui->actionOther);
+    action->setChecked(true);
 }
 /*************************/
 const QString FPwin::checkToEncoding() const {
@@ -3981,6 +4090,8 @@ const QString FPwin::checkToEncoding() const {
         encoding = "UTF-16";
     else if (ui->actionISO_8859_1->isChecked())
         encoding = "ISO-8859-1";
+    else if (aGroup_->checkedAction() && !aGroup_->checkedAction()->data().toString().isEmpty())
+        encoding = aGroup_->checkedAction()->data().toString();
     else
         encoding = "UTF-8";
 
@@ -3995,7 +4106,7 @@ void FPwin::docProp() {
             disconnect(thisTextEdit, &QPlainTextEdit::blockCountChanged, this, &FPwin::statusMsgWithLineCount);
             disconnect(thisTextEdit, &TextEdit::selChanged, this, &FPwin::statusMsg);
             if (showCurPos)
-                disconnect(thisTextEdit, &QPlainTextEdit::cursorPositionChanged, this, &FPwin::showCursorPos);
+                disconnect(thisTextEdit, &TextEdit::cursorMoved, this, &FPwin::showCursorPos);
             /* don't delete the cursor position label because the statusbar might be shown later */
         }
         ui->statusBar->setVisible(false);
@@ -4012,7 +4123,7 @@ void FPwin::docProp() {
         connect(thisTextEdit, &QPlainTextEdit::blockCountChanged, this, &FPwin::statusMsgWithLineCount);
         connect(thisTextEdit, &TextEdit::selChanged, this, &FPwin::statusMsg);
         if (showCurPos)
-            connect(thisTextEdit, &QPlainTextEdit::cursorPositionChanged, this, &FPwin::showCursorPos);
+            connect(thisTextEdit, &TextEdit::cursorMoved, this, &FPwin::showCursorPos);
     }
 
     ui->statusBar->setVisible(true);
@@ -4032,58 +4143,40 @@ void FPwin::statusMsgWithLineCount(const int lines) {
     if (qobject_cast<TextEdit*>(QObject::sender()) && QObject::sender() != textEdit)
         return;
 
-    QLabel* statusLabel = ui->statusBar->findChild<QLabel*>("statusLabel");
-
-    /* the order: Encoding -> Syntax -> Lines -> Sel. Chars -> Words */
-    QString encodStr = "<b>" + tr("Encoding") + QString(":</b> <i>%1</i>").arg(textEdit->getEncoding());
-    QString syntaxStr;
+    statusInfo_->setEncoding(textEdit->getEncoding());
     if (textEdit->getProg() != "help" && textEdit->getProg() != "url")
-        syntaxStr = "&nbsp;&nbsp;&nbsp;<b>" + tr("Syntax") + QString(":</b> <i>%1</i>").arg(textEdit->getProg());
-    QLocale l = locale();
-    QString lineStr = "&nbsp;&nbsp;&nbsp;<b>" + tr("Lines") + QString(":</b> <i>%1</i>").arg(l.toString(lines));
-    QString selStr = "&nbsp;&nbsp;&nbsp;<b>" + tr("Sel. Chars") +
-                     QString(":</b> <i>%1</i>").arg(l.toString(textEdit->selectionSize()));
-    QString wordStr = "&nbsp;&nbsp;&nbsp;<b>" + tr("Words") + ":</b>";
-
-    statusLabel->setText(encodStr + syntaxStr + lineStr + selStr + wordStr);
+        statusInfo_->setSyntax(textEdit->getProg());
+    else
+        statusInfo_->setSyntax(QString());
+    statusInfo_->setLines(lines);
+    showSelectionInfo(qobject_cast<TabPage*>(ui->tabWidget->currentWidget()));
+    statusInfo_->setWords(textEdit->getWordNumber());
 }
 /*************************/
 // Change the status bar text when the selection changes.
 void FPwin::statusMsg() {
-    QLocale l = locale();
-    QLabel* statusLabel = ui->statusBar->findChild<QLabel*>("statusLabel");
-    int sel = qobject_cast<TabPage*>(ui->tabWidget->currentWidget())->textEdit()->selectionSize();
-    QString str = statusLabel->text();
-    QString selStr = tr("Sel. Chars");
-    QString wordStr = "&nbsp;&nbsp;&nbsp;<b>" + tr("Words");
-    int i = str.indexOf(selStr) + selStr.size();
-    int j = str.indexOf(wordStr);
-    if (sel == 0) {
-        QString prevSel = str.mid(i + 9, j - i - 13);  // j - i - 13 --> j - (i + 9[":</b> <i>]") - 4["</i>"]
-        if (l.toInt(prevSel) == 0)
-            return;
+    showSelectionInfo(qobject_cast<TabPage*>(ui->tabWidget->currentWidget()));
+}
+/*************************/
+// Shows the selection numbers of the page, which are computed only if they aren't cached.
+void FPwin::showSelectionInfo(TabPage* tabPage) {
+    const TabPage::UiState& state = tabPage->uiState();
+    if (state.selChars < 0) {
+        const TextEdit::selectionStats sel = tabPage->textEdit()->selectionInfo();
+        tabPage->setSelectionInfo(sel.chars, sel.lines, sel.words);
     }
-    QString charN = l.toString(sel);
-    str.replace(i + 9, j - i - 13, charN);
-    statusLabel->setText(str);
+    statusInfo_->setSelection(state.selChars, state.selLines, state.selWords);
 }
 /*************************/
 void FPwin::showCursorPos() {
-    QLabel* posLabel = ui->statusBar->findChild<QLabel*>("posLabel");
-    if (!posLabel)
+    if (!posSegment_)
         return;
 
     TabPage* tabPage = qobject_cast<TabPage*>(ui->tabWidget->currentWidget());
     if (tabPage == nullptr)
         return;
 
-    int pos = tabPage->textEdit()->textCursor().positionInBlock();
-    QString charN = "<i> " + locale().toString(pos) + "</i>";
-    QString str = posLabel->text();
-    QString scursorStr = "<b>" + tr("Position:") + "</b>";
-    int i = scursorStr.size();
-    str.replace(i, str.size() - i, charN);
-    posLabel->setText(str);
+    posSegment_->setValue(locale().toString(tabPage->textEdit()->textCursor().positionInBlock()));
 }
 /*************************/
 void FPwin::updateLangBtn(TextEdit* textEdit) {
@@ -4137,6 +4230,8 @@ void FPwin::enforceLang(QAction* action) {
         syntaxHighlighting(textEdit, true, lang);
         QTimer::singleShot(0, this, &FPwin::unbusy);
     }
+    if (outline_)
+        outline_->refresh();
 }
 /*************************/
 void FPwin::updateWordInfo(int /*position*/, int charsRemoved, int charsAdded) {
@@ -4152,7 +4247,6 @@ void FPwin::updateWordInfo(int /*position*/, int charsRemoved, int charsAdded) {
         return;
 
     if (wordButton->isVisible()) {
-        QLabel* statusLabel = ui->statusBar->findChild<QLabel*>("statusLabel");
         int words = textEdit->getWordNumber();
         if (words == -1) {
             words = textEdit->toPlainText().split(QRegularExpression("(\\s|\\n|\\r)+"), Qt::SkipEmptyParts).count();
@@ -4160,7 +4254,7 @@ void FPwin::updateWordInfo(int /*position*/, int charsRemoved, int charsAdded) {
         }
 
         wordButton->setVisible(false);
-        statusLabel->setText(QString("%1 <i>%2</i>").arg(statusLabel->text(), locale().toString(words)));
+        statusInfo_->setWords(words);
         connect(textEdit->document(), &QTextDocument::contentsChange, this, &FPwin::updateWordInfo);
     }
     else if (charsRemoved > 0 || charsAdded > 0)  // not if only the format is changed
@@ -4357,7 +4451,7 @@ void FPwin::detachTab() {
         return;
     }
 
-    Config config = static_cast<FPsingleton*>(qApp)->getConfig();
+    const Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
 
     /*****************************************************
      *****          Get all necessary info.          *****
@@ -4380,7 +4474,7 @@ void FPwin::detachTab() {
         ln = true;
     if (ui->statusBar->isVisible()) {
         status = true;
-        if (ui->statusBar->findChild<QLabel*>("posLabel"))
+        if (posSegment_)
             statusCurPos = true;
     }
 
@@ -4393,7 +4487,7 @@ void FPwin::detachTab() {
         disconnect(textEdit, &QPlainTextEdit::blockCountChanged, this, &FPwin::statusMsgWithLineCount);
         disconnect(textEdit, &TextEdit::selChanged, this, &FPwin::statusMsg);
         if (statusCurPos)
-            disconnect(textEdit, &QPlainTextEdit::cursorPositionChanged, this, &FPwin::showCursorPos);
+            disconnect(textEdit, &TextEdit::cursorMoved, this, &FPwin::showCursorPos);
     }
     disconnect(textEdit, &TextEdit::canCopy, ui->actionCut, &QAction::setEnabled);
     disconnect(textEdit, &TextEdit::canCopy, ui->actionDelete, &QAction::setEnabled);
@@ -4404,6 +4498,7 @@ void FPwin::detachTab() {
     disconnect(textEdit, &QWidget::customContextMenuRequested, this, &FPwin::editorContextMenu);
     disconnect(textEdit, &TextEdit::zoomedOut, this, &FPwin::reformat);
     disconnect(textEdit, &TextEdit::hugeColumn, this, &FPwin::columnWarning);
+    disconnect(textEdit, &TextEdit::pasting, this, &FPwin::pauseAutoSaving);
     disconnect(textEdit, &TextEdit::filePasted, this, &FPwin::newTabFromName);
     disconnect(textEdit, &TextEdit::updateBracketMatching, this, &FPwin::matchBrackets);
     disconnect(textEdit, &QPlainTextEdit::blockCountChanged, this, &FPwin::formatOnBlockChange);
@@ -4427,6 +4522,7 @@ void FPwin::detachTab() {
     ui->tabWidget->tabBar()->releaseMouse();
 
     ui->tabWidget->removeTab(index);
+    unwatchClosedFiles();
     if (ui->tabWidget->count() == 1)
         updateGUIForSingleTab(true);
     if (sidePane_ && !sideItems_.isEmpty()) {
@@ -4451,6 +4547,7 @@ void FPwin::detachTab() {
 
     /* first, set the new info... */
     dropTarget->lastFile_ = textEdit->getFileName();
+    tabPage->setFileState(TabPage::FileUnknown);  // to be watched by the new window
     textEdit->setGreenSel(QList<QTextEdit::ExtraSelection>());
     textEdit->setRedSel(QList<QTextEdit::ExtraSelection>());
     /* ... then insert the detached widget... */
@@ -4538,9 +4635,6 @@ void FPwin::detachTab() {
         else {
             if (QToolButton* wordButton = dropTarget->ui->statusBar->findChild<QToolButton*>("wordButton"))
                 wordButton->setVisible(false);
-            QLabel* statusLabel = dropTarget->ui->statusBar->findChild<QLabel*>("statusLabel");
-            statusLabel->setText(
-                QString("%1 <i>%2</i>").arg(statusLabel->text(), locale().toString(textEdit->getWordNumber())));
             connect(textEdit->document(), &QTextDocument::contentsChange, dropTarget, &FPwin::updateWordInfo);
         }
         connect(textEdit, &QPlainTextEdit::blockCountChanged, dropTarget, &FPwin::statusMsgWithLineCount);
@@ -4548,7 +4642,7 @@ void FPwin::detachTab() {
         if (statusCurPos) {
             dropTarget->addCursorPosLabel();
             dropTarget->showCursorPos();
-            connect(textEdit, &QPlainTextEdit::cursorPositionChanged, dropTarget, &FPwin::showCursorPos);
+            connect(textEdit, &TextEdit::cursorMoved, dropTarget, &FPwin::showCursorPos);
         }
     }
     if (textEdit->lineWrapMode() == QPlainTextEdit::NoWrap)
@@ -4577,6 +4671,7 @@ void FPwin::detachTab() {
     connect(textEdit, &TextEdit::filePasted, dropTarget, &FPwin::newTabFromName);
     connect(textEdit, &TextEdit::zoomedOut, dropTarget, &FPwin::reformat);
     connect(textEdit, &TextEdit::hugeColumn, dropTarget, &FPwin::columnWarning);
+    connect(textEdit, &TextEdit::pasting, dropTarget, &FPwin::pauseAutoSaving);
     connect(textEdit, &QWidget::customContextMenuRequested, dropTarget, &FPwin::editorContextMenu);
 
     textEdit->setFocus();
@@ -4624,7 +4719,7 @@ void FPwin::dropTab(const QString& str, QObject* source) {
     if (dragSource->ui->actionLineNumbers->isChecked())
         ln = true;
 
-    Config config = static_cast<FPsingleton*>(qApp)->getConfig();
+    const Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
 
     disconnect(textEdit, &TextEdit::resized, dragSource, &FPwin::hlight);
     disconnect(textEdit, &TextEdit::updateRect, dragSource, &FPwin::hlight);
@@ -4632,8 +4727,8 @@ void FPwin::dropTab(const QString& str, QObject* source) {
     if (dragSource->ui->statusBar->isVisible()) {
         disconnect(textEdit, &QPlainTextEdit::blockCountChanged, dragSource, &FPwin::statusMsgWithLineCount);
         disconnect(textEdit, &TextEdit::selChanged, dragSource, &FPwin::statusMsg);
-        if (dragSource->ui->statusBar->findChild<QLabel*>("posLabel"))
-            disconnect(textEdit, &QPlainTextEdit::cursorPositionChanged, dragSource, &FPwin::showCursorPos);
+        if (dragSource->posSegment_)
+            disconnect(textEdit, &TextEdit::cursorMoved, dragSource, &FPwin::showCursorPos);
     }
     disconnect(textEdit, &TextEdit::canCopy, dragSource->ui->actionCut, &QAction::setEnabled);
     disconnect(textEdit, &TextEdit::canCopy, dragSource->ui->actionDelete, &QAction::setEnabled);
@@ -4644,6 +4739,7 @@ void FPwin::dropTab(const QString& str, QObject* source) {
     disconnect(textEdit, &QWidget::customContextMenuRequested, dragSource, &FPwin::editorContextMenu);
     disconnect(textEdit, &TextEdit::zoomedOut, dragSource, &FPwin::reformat);
     disconnect(textEdit, &TextEdit::hugeColumn, dragSource, &FPwin::columnWarning);
+    disconnect(textEdit, &TextEdit::pasting, dragSource, &FPwin::pauseAutoSaving);
     disconnect(textEdit, &TextEdit::filePasted, dragSource, &FPwin::newTabFromName);
     disconnect(textEdit, &TextEdit::updateBracketMatching, dragSource, &FPwin::matchBrackets);
     disconnect(textEdit, &QPlainTextEdit::blockCountChanged, dragSource, &FPwin::formatOnBlockChange);
@@ -4667,6 +4763,7 @@ void FPwin::dropTab(const QString& str, QObject* source) {
     dragSource->ui->tabWidget->tabBar()->releaseMouse();
 
     dragSource->ui->tabWidget->removeTab(index);  // there can't be a side-pane here
+    dragSource->unwatchClosedFiles();
     int count = dragSource->ui->tabWidget->count();
     if (count == 1)
         dragSource->updateGUIForSingleTab(true);
@@ -4679,6 +4776,7 @@ void FPwin::dropTab(const QString& str, QObject* source) {
 
     /* first, set the new info... */
     lastFile_ = textEdit->getFileName();
+    tabPage->setFileState(TabPage::FileUnknown);  // to be watched by this window
     textEdit->setGreenSel(QList<QTextEdit::ExtraSelection>());
     textEdit->setRedSel(QList<QTextEdit::ExtraSelection>());
     /* ... then insert the detached widget,
@@ -4778,9 +4876,9 @@ void FPwin::dropTab(const QString& str, QObject* source) {
     if (ui->statusBar->isVisible()) {
         connect(textEdit, &QPlainTextEdit::blockCountChanged, this, &FPwin::statusMsgWithLineCount);
         connect(textEdit, &TextEdit::selChanged, this, &FPwin::statusMsg);
-        if (ui->statusBar->findChild<QLabel*>("posLabel")) {
+        if (posSegment_) {
             showCursorPos();
-            connect(textEdit, &QPlainTextEdit::cursorPositionChanged, this, &FPwin::showCursorPos);
+            connect(textEdit, &TextEdit::cursorMoved, this, &FPwin::showCursorPos);
         }
         if (textEdit->getWordNumber() != -1)
             connect(textEdit->document(), &QTextDocument::contentsChange, this, &FPwin::updateWordInfo);
@@ -4815,6 +4913,7 @@ void FPwin::dropTab(const QString& str, QObject* source) {
     connect(textEdit, &TextEdit::filePasted, this, &FPwin::newTabFromName);
     connect(textEdit, &TextEdit::zoomedOut, this, &FPwin::reformat);
     connect(textEdit, &TextEdit::hugeColumn, this, &FPwin::columnWarning);
+    connect(textEdit, &TextEdit::pasting, this, &FPwin::pauseAutoSaving);
     connect(textEdit, &QWidget::customContextMenuRequested, this, &FPwin::editorContextMenu);
 
     textEdit->setFocus();
@@ -5050,6 +5149,27 @@ void FPwin::listContextMenu(const QPoint& p) {
     rightClicked_ = -1;  // reset
 }
 /*************************/
+void FPwin::toggleOutline() {
+    if (outlineDock_ == nullptr) {
+        outline_ = new OutlinePane;
+        outlineDock_ = new QDockWidget(tr("Outline"), this);
+        outlineDock_->setObjectName("dockOutline");
+        outlineDock_->setAllowedAreas(Qt::LeftDockWidgetArea | Qt::RightDockWidgetArea);
+        outlineDock_->setWidget(outline_);
+        addDockWidget(Qt::RightDockWidgetArea, outlineDock_);
+        /* the outline follows the current document only when it's visible */
+        connect(outlineDock_, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+            TabPage* tabPage = visible ? qobject_cast<TabPage*>(ui->tabWidget->currentWidget()) : nullptr;
+            outline_->setTextEdit(tabPage ? tabPage->textEdit() : nullptr);
+        });
+        outlineDock_->show();
+        if (TabPage* tabPage = qobject_cast<TabPage*>(ui->tabWidget->currentWidget()))
+            outline_->setTextEdit(tabPage->textEdit());
+        return;
+    }
+    outlineDock_->setVisible(!outlineDock_->isVisible());
+}
+/*************************/
 void FPwin::prefDialog() {
     if (isLoading())
         return;
@@ -5132,7 +5252,7 @@ void FPwin::checkSpelling() {
     if (hasAnotherDialog())
         return;
 
-    Config config = static_cast<FPsingleton*>(qApp)->getConfig();
+    const Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
     auto dictPath = config.getDictPath();
     if (dictPath.isEmpty()) {
         showWarningBar("<center><b><big>" + tr("You need to add a Hunspell dictionary.") + "</big></b></center>" +
@@ -5182,6 +5302,7 @@ void FPwin::checkSpelling() {
     }
 
     SpellChecker* spellChecker = new SpellChecker(dictPath, userDict);
+    textEdit->vScrollBar()->clearMarkers(VScrollBar::SpellMarker);
 
     while (spellChecker->spell(word)) {
         cur.setPosition(cur.position());
@@ -5213,6 +5334,7 @@ void FPwin::checkSpelling() {
     textEdit->skipSelectionHighlighting();
     textEdit->setTextCursor(cur);
     textEdit->ensureCursorVisible();
+    textEdit->vScrollBar()->addMarker(VScrollBar::SpellMarker, cur.blockNumber());
 
     updateShortcuts(true);
     SpellDialog dlg(spellChecker, word,
@@ -5229,16 +5351,20 @@ void FPwin::checkSpelling() {
         QString corrected;
         switch (res) {
             case SpellDialog::CorrectOnce:
-                if (!uneditable)
+                if (!uneditable) {
+                    textEdit->vScrollBar()->removeMarker(VScrollBar::SpellMarker, cur.blockNumber());
                     cur.insertText(dlg.replacement());
+                }
                 break;
             case SpellDialog::IgnoreOnce:
                 break;
             case SpellDialog::CorrectAll:
                 /* remember this corretion */
                 dlg.spellChecker()->addToCorrections(word, dlg.replacement());
-                if (!uneditable)
+                if (!uneditable) {
+                    textEdit->vScrollBar()->removeMarker(VScrollBar::SpellMarker, cur.blockNumber());
                     cur.insertText(dlg.replacement());
+                }
                 break;
             case SpellDialog::IgnoreAll:
                 /* always ignore the selected word */
@@ -5309,6 +5435,7 @@ void FPwin::checkSpelling() {
         textEdit->skipSelectionHighlighting();
         textEdit->setTextCursor(cur);
         textEdit->ensureCursorVisible();
+        textEdit->vScrollBar()->addMarker(VScrollBar::SpellMarker, cur.blockNumber());
         dlg.checkWord(word);
     });
 
@@ -5319,7 +5446,7 @@ void FPwin::checkSpelling() {
 }
 /*************************/
 void FPwin::userDict() {
-    Config config = static_cast<FPsingleton*>(qApp)->getConfig();
+    const Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
     QString dictPath = config.getDictPath();
     if (dictPath.isEmpty())
         showWarningBar("<center><b><big>" + tr("The file does not exist.") + "</big></b></center>");
@@ -5419,7 +5546,8 @@ void FPwin::saveAllFiles(bool showWarning) {
     for (int indx = 0; indx < ui->tabWidget->count(); ++indx) {
         TabPage* thisTabPage = qobject_cast<TabPage*>(ui->tabWidget->widget(indx));
         TextEdit* thisTextEdit = thisTabPage->textEdit();
-        if (thisTextEdit->isUneditable() || !thisTextEdit->document()->isModified())
+        /* a document that is being pasted into has an open edit block */
+        if (thisTextEdit->isUneditable() || thisTextEdit->isPasting() || !thisTextEdit->document()->isModified())
             continue;
         QString fname = thisTextEdit->getFileName();
         if (fname.isEmpty() || !QFile::exists(fname))
@@ -5430,28 +5558,9 @@ void FPwin::saveAllFiles(bool showWarning) {
             makeBusy();
             bool doubleSpace(thisTextEdit->getProg() == "markdown" || thisTextEdit->getProg() == "fountain");
             bool singleSpace(thisTextEdit->getProg() == "LaTeX");
-            QTextBlock block = thisTextEdit->document()->firstBlock();
-            QTextCursor tmpCur = thisTextEdit->textCursor();
-            tmpCur.beginEditBlock();
-            while (block.isValid()) {
-                if (const int num = trailingSpaces(block.text())) {
-                    tmpCur.setPosition(block.position() + block.text().length());
-                    if (doubleSpace) {
-                        if (num != 2)
-                            tmpCur.movePosition(QTextCursor::PreviousCharacter, QTextCursor::KeepAnchor,
-                                                std::max(1, num - 2));
-                    }
-                    else if (singleSpace) {
-                        if (num > 1)
-                            tmpCur.movePosition(QTextCursor::PreviousCharacter, QTextCursor::KeepAnchor, num - 1);
-                    }
-                    else
-                        tmpCur.movePosition(QTextCursor::PreviousCharacter, QTextCursor::KeepAnchor, num);
-                    tmpCur.removeSelectedText();
-                }
-                block = block.next();
-            }
-            tmpCur.endEditBlock();
+            QTextDocument* doc = thisTextEdit->document();
+            thisTextEdit->replaceRange(0, doc->characterCount() - 1,
+                                       textWithoutTrailingSpaces(doc, doubleSpace, singleSpace));
             unbusy();
         }
         if (config.getAppendEmptyLine() && !thisTextEdit->document()->lastBlock().text().isEmpty()) {
@@ -5469,6 +5578,7 @@ void FPwin::saveAllFiles(bool showWarning) {
             QFileInfo fInfo(fname);
             thisTextEdit->setSize(fInfo.size());
             thisTextEdit->setLastModified(fInfo.lastModified());
+            watchFile(thisTabPage, fInfo);
             setTitle(fname, (!inactiveTabModified_ ? -1 : indx));
             addRecentFile(fname);  // recently saved also means recently opened
             /* uninstall and reinstall the syntax highlighter if the programming language is changed */
@@ -5494,38 +5604,8 @@ void FPwin::saveAllFiles(bool showWarning) {
                         syntaxHighlighting(thisTextEdit);
                 }
 
-                if (!inactiveTabModified_ &&
-                    ui->statusBar->isVisible()) {  // correct the statusbar text just by replacing the old syntax info
-                    QLabel* statusLabel = ui->statusBar->findChild<QLabel*>("statusLabel");
-                    QString str = statusLabel->text();
-                    QString syntaxStr = tr("Syntax");
-                    int i = str.indexOf(syntaxStr);
-                    if (i == -1)  // there was no real language before saving (prevLan was "url")
-                    {
-                        QString lineStr = "&nbsp;&nbsp;&nbsp;<b>" + tr("Lines");
-                        int j = str.indexOf(lineStr);
-                        syntaxStr = "&nbsp;&nbsp;&nbsp;<b>" + tr("Syntax") +
-                                    QString(":</b> <i>%1</i>").arg(thisTextEdit->getProg());
-                        str.insert(j, syntaxStr);
-                    }
-                    else {
-                        if (thisTextEdit->getProg() == "url")  // there's no real language after saving
-                        {
-                            syntaxStr = "&nbsp;&nbsp;&nbsp;<b>" + tr("Syntax");
-                            QString lineStr = "&nbsp;&nbsp;&nbsp;<b>" + tr("Lines");
-                            int j = str.indexOf(syntaxStr);
-                            int k = str.indexOf(lineStr);
-                            str.remove(j, k - j);
-                        }
-                        else  // the language is changed by saving
-                        {
-                            QString lineStr = "</i>&nbsp;&nbsp;&nbsp;<b>" + tr("Lines");
-                            int j = str.indexOf(lineStr);
-                            int offset = syntaxStr.size() + 9;  // size of ":</b> <i>"
-                            str.replace(i + offset, j - i - offset, thisTextEdit->getProg());
-                        }
-                    }
-                    statusLabel->setText(str);
+                if (!inactiveTabModified_ && ui->statusBar->isVisible()) {  // correct the syntax info of the statusbar
+                    statusInfo_->setSyntax(thisTextEdit->getProg() == "url" ? QString() : thisTextEdit->getProg());
                     if (thisTextEdit->getWordNumber() != -1)
                         connect(thisTextEdit->document(), &QTextDocument::contentsChange, this, &FPwin::updateWordInfo);
                 }
@@ -23,10 +23,14 @@
 #include <QMainWindow>
 #include <QActionGroup>
 #include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QFileInfo>
+#include <QPointer>
 #include "highlighter/highlighter.h"
 #include "textedit.h"
 #include "tabpage.h"
 #include "sidepane.h"
+#include "statusinfo.h"
 #include "config.h"
 
 namespace FeatherPad {
@@ -35,6 +39,8 @@ namespace Ui {
 class FPwin;
 }
 
+class OutlinePane;
+
 // A FeatherPad window.
 class FPwin : public QMainWindow {
     Q_OBJECT
@@ -72,6 +78,9 @@ class FPwin : public QMainWindow {
 
     void menubarTitle(bool add = true, bool setTitle = false);
 
+    void applyPrefs(TabPage* tabPage) const;
+    void applyPrefsToCurrentTab() const;
+
    signals:
     void finishedLoading();
 
@@ -158,8 +167,6 @@ class FPwin : public QMainWindow {
     void manageSessions();
     void executeProcess();
     void exitProcess();
-    void displayError();
-    void displayOutput();
     void docProp();
     void filePrint();
     void detachTab();
@@ -173,6 +180,7 @@ class FPwin : public QMainWindow {
     void editorContextMenu(const QPoint& p);
     void changeTab(QListWidgetItem* current);
     void toggleSidePane();
+    void toggleOutline();
     void prefDialog();
     void checkSpelling();
     void userDict();
@@ -193,6 +201,7 @@ class FPwin : public QMainWindow {
     void onPermissionDenied();
     void onOpeningUneditable();
     void onOpeningNonexistent();
+    void onWatchedFileChanged(const QString& path);
     void columnWarning();
     void autoSave();
     void pauseAutoSaving(bool pause);
@@ -217,7 +226,8 @@ class FPwin : public QMainWindow {
                   int restoreCursor = 0,
                   int posInLine = 0,
                   bool enforceUneditable = false,
-                  bool multiple = false);
+                  bool multiple = false,
+                  const QByteArray& rawBytes = QByteArray());
     bool alreadyOpen(TabPage* tabPage) const;
     void setWinTitle(const QString& title);
     void setTitle(const QString& fileName, int tabIndex = -1);
@@ -247,6 +257,7 @@ class FPwin : public QMainWindow {
     void saveAllFiles(bool showWarning);
     void closeEvent(QCloseEvent* event);
     bool closePages(int first, int last, bool saveFilesList = false);
+    void finishBulkClose();
     void dragEnterEvent(QDragEnterEvent* event);
     void dropEvent(QDropEvent* event);
     void dropTab(const QString& str, QObject* source);
@@ -259,6 +270,9 @@ class FPwin : public QMainWindow {
     void setProgLang(TextEdit* textEdit);
     void syntaxHighlighting(TextEdit* textEdit, bool highlight = true, const QString& lang = QString());
     void encodingToCheck(const QString& encoding);
+    QAction* encodingAction(const QString& encoding) const;
+    void checkEncodingAction(QAction* action);
+    void showSelectionInfo(TabPage* tabPage);
     const QString checkToEncoding() const;
     void applyConfigOnStarting();
     bool matchLeftParenthesis(QTextBlock currentBlock, int index, int numRightParentheses);
@@ -270,7 +284,6 @@ class FPwin : public QMainWindow {
     void createSelection(int pos);
     void removeGreenSel();
     void makeBusy();
-    void displayMessage(bool error);
     void showWarningBar(const QString& message, int timeout = 10, bool startupBar = false);
     void closeWarningBar(bool keepOnStartup = false);
     void disconnectLambda();
@@ -288,15 +301,26 @@ class FPwin : public QMainWindow {
                                      TextEdit* textEdit,
                                      const QString& encoding,
                                      bool& MSWinLineEnd);
+    void watchFile(TabPage* tabPage, const QFileInfo& info);
+    void unwatchClosedFiles();
+    void updateFileState(TabPage* tabPage, const QFileInfo& info) const;
+    void warnAboutFileState(TabPage* tabPage);
+    void showHexView(const QString& fileName);
 
     QActionGroup* aGroup_;
     QString lastFile_;                          // The last opened or saved file (for file dialogs).
     QHash<QString, QVariant> lastWinFilesCur_;  // The last window files and their cusrors (if restored).
     int rightClicked_;                          // The index/row of the right-clicked tab/item.
     int loadingProcesses_;                      // The number of loading processes (used to prevent early closing).
+    QStringList skippedNonText_;                // The non-text files skipped by the current loading processes.
     QMetaObject::Connection lambdaConnection_;  // Captures a lambda connection to disconnect it later.
     SidePane* sidePane_;
     QHash<QListWidgetItem*, TabPage*> sideItems_;  // For fast tab switching.
+    QDockWidget* outlineDock_;                     // Created on demand.
+    OutlinePane* outline_;
+    QFileSystemWatcher* fileWatcher_;              // Watches the files of tabs.
+    StatusInfo* statusInfo_;
+    QPointer<StatusSegment> posSegment_;           // The cursor position (optional).
     QHash<QString, QAction*> langs_;               // All programming languages (to be enforced by the user).
     QHash<QAction*, QKeySequence> defaultShortcuts_;
     bool inactiveTabModified_;  // The inactive tab is modified (e.g., when saving all files).
@@ -308,6 +332,9 @@ class FPwin : public QMainWindow {
     // Needed with saving as root:
     bool locked_;
     bool closePreviousPages_;
+    // Closing several pages at once:
+    bool bulkClosing_;
+    QList<QTextDocument*> closedDocs_;  // Deleted in idle time when the closing is finished.
 };
 
 }  // namespace FeatherPad
@@ -0,0 +1,493 @@
+/*
+ * Copyright (C) Pedram Pourang (aka Tsu Jan) 2026 <tsujan2000@gmail.com>
+ *
+ * FeatherPad is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FeatherPad is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @license GPL-3.0+ <https://spdx.org/licenses/GPL-3.0+.html>
+ */
+
+#include "hexview.h"
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QPushButton>
+#include <QScrollBar>
+#include <QPainter>
+#include <QKeyEvent>
+#include <QFontDatabase>
+#include <QRegularExpression>
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <iterator>
+
+#define BYTES_PER_ROW 16
+#define SEARCH_CHUNK (4 * 1024 * 1024)  // in bytes
+
+namespace FeatherPad {
+
+static inline QChar hexDigit(int n) {
+    return QLatin1Char(n < 10 ? '0' + n : 'a' + n - 10);
+}
+
+/* The first match of the pattern in [start, end), or -1. The Boyer-Moore-Horspool
+   search skips most bytes and, unlike memmem(), is available everywhere. */
+static qint64 forwardFind(const char* data, qint64 start, qint64 end, const QByteArray& pattern) {
+    const char* last = data + end;
+    const char* p = std::search(data + start, last,
+                                std::boyer_moore_horspool_searcher(pattern.cbegin(), pattern.cend()));
+    return p == last ? -1 : p - data;
+}
+/*************************/
+/* The last match of the pattern that starts in [lowest, from], or -1.
+   ("from" should not be greater than the size minus the pattern length.)
+   The reversed pattern is searched for backward, with the same algorithm. */
+static qint64 reverseFind(const char* data, qint64 lowest, qint64 from, const QByteArray& pattern) {
+    QByteArray reversed = pattern;
+    std::reverse(reversed.begin(), reversed.end());
+    const std::reverse_iterator<const char*> first(data + from + pattern.size());
+    const std::reverse_iterator<const char*> last(data + lowest);
+    const auto p =
+        std::search(first, last, std::boyer_moore_horspool_searcher(reversed.cbegin(), reversed.cend()));
+    /* "p" points to the last byte of the match */
+    return p == last ? -1 : p.base() - data - pattern.size();
+}
+/*************************/
+HexSearcher::HexSearcher(const char* data, qint64 size, const QByteArray& pattern, qint64 from, bool forward)
+    : QThread(),
+      data_(data),
+      size_(size),
+      pattern_(pattern),
+      from_(from),
+      forward_(forward),
+      total_(0),
+      scanned_(0),
+      percent_(0) {}
+/*************************/
+void HexSearcher::run() {
+    const qint64 len = pattern_.size();
+    qint64 offset = -1;
+    if (forward_) {
+        /* after wrapping around, only the matches that start before "from_" remain */
+        const qint64 wrapEnd = from_ > 0 ? qMin(size_, from_ + len - 1) : 0;
+        total_ = size_ - from_ + wrapEnd;
+        offset = searchForward(from_, size_);
+        if (offset == -1 && wrapEnd > 0)
+            offset = searchForward(0, wrapEnd);
+    }
+    else {
+        const qint64 last = size_ - len;
+        total_ = last + 1;
+        if (from_ >= 0)
+            offset = searchBackward(0, from_);
+        if (offset == -1 && from_ < last)  // wrap around
+            offset = searchBackward(qMax<qint64>(from_ + 1, 0), last);
+    }
+    if (!isInterruptionRequested())
+        emit found(offset);
+}
+/*************************/
+// Searches [start, end) chunk by chunk. Consecutive chunks overlap by the pattern length minus one.
+qint64 HexSearcher::searchForward(qint64 start, qint64 end) {
+    for (qint64 chunk = start; chunk < end; chunk += SEARCH_CHUNK) {
+        if (isInterruptionRequested())
+            return -1;
+        const qint64 chunkEnd = qMin(end, chunk + SEARCH_CHUNK + pattern_.size() - 1);
+        const qint64 found = forwardFind(data_, chunk, chunkEnd, pattern_);
+        if (found >= 0)
+            return found;
+        addScanned(qMin<qint64>(end - chunk, SEARCH_CHUNK));
+    }
+    return -1;
+}
+/*************************/
+// Searches for the last match that starts in [lowest, from], chunk by chunk.
+qint64 HexSearcher::searchBackward(qint64 lowest, qint64 from) {
+    for (qint64 chunk = from; chunk >= lowest; chunk -= SEARCH_CHUNK) {
+        if (isInterruptionRequested())
+            return -1;
+        const qint64 chunkStart = qMax(lowest, chunk - SEARCH_CHUNK + 1);
+        const qint64 found = reverseFind(data_, chunkStart, chunk, pattern_);
+        if (found >= 0)
+            return found;
+        addScanned(chunk - chunkStart + 1);
+    }
+    return -1;
+}
+/*************************/
+void HexSearcher::addScanned(qint64 bytes) {
+    scanned_ += bytes;
+    const int percent = total_ > 0 ? static_cast<int>(qMin<qint64>(scanned_ * 100 / total_, 100)) : 100;
+    if (percent != percent_) {
+        percent_ = percent;
+        emit progress(percent);
+    }
+}
+/*************************/
+HexView::HexView(QWidget* parent)
+    : QAbstractScrollArea(parent), data_(nullptr), size_(0), selStart_(0), selLength_(0), offsetDigits_(8) {
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setFocusPolicy(Qt::StrongFocus);
+}
+/*************************/
+HexView::~HexView() {
+    cancelSearch();
+    if (data_ != nullptr)
+        file_.unmap(const_cast<uchar*>(data_));
+}
+/*************************/
+bool HexView::setFile(const QString& fileName) {
+    cancelSearch();
+    if (data_ != nullptr) {
+        file_.unmap(const_cast<uchar*>(data_));
+        data_ = nullptr;
+    }
+    file_.close();
+    size_ = selStart_ = selLength_ = 0;
+
+    file_.setFileName(fileName);
+    if (!file_.open(QIODevice::ReadOnly) || file_.size() <= 0)
+        return false;
+    /* the pages are read only when they are painted or searched */
+    data_ = file_.map(0, file_.size());
+    if (data_ == nullptr)
+        return false;
+    size_ = file_.size();
+    offsetDigits_ = size_ > 0xffffffffLL ? 16 : 8;
+
+    verticalScrollBar()->setValue(0);
+    horizontalScrollBar()->setValue(0);
+    updateScrollBars();
+    viewport()->update();
+    return true;
+}
+/*************************/
+int HexView::visibleRows() const {
+    return qMax(1, viewport()->height() / qMax(1, fontMetrics().height()));
+}
+/*************************/
+void HexView::updateScrollBars() {
+    const qint64 rows = (size_ + BYTES_PER_ROW - 1) / BYTES_PER_ROW;
+    const int pageRows = visibleRows();
+    verticalScrollBar()->setRange(0, static_cast<int>(qMin<qint64>(qMax<qint64>(0, rows - pageRows), INT_MAX)));
+    verticalScrollBar()->setPageStep(pageRows);
+    verticalScrollBar()->setSingleStep(1);
+
+    const int charWidth = fontMetrics().horizontalAdvance(QLatin1Char('0'));
+    const int width = (offsetDigits_ + 2 + BYTES_PER_ROW * 3 + 2 + BYTES_PER_ROW) * charWidth;
+    horizontalScrollBar()->setRange(0, qMax(0, width - viewport()->width()));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setSingleStep(charWidth);
+}
+/*************************/
+void HexView::resizeEvent(QResizeEvent* event) {
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+/*************************/
+void HexView::changeEvent(QEvent* event) {
+    if (event->type() == QEvent::FontChange)
+        updateScrollBars();
+    QAbstractScrollArea::changeEvent(event);
+}
+/*************************/
+void HexView::keyPressEvent(QKeyEvent* event) {
+    QScrollBar* vbar = verticalScrollBar();
+    switch (event->key()) {
+        case Qt::Key_Up:
+            vbar->triggerAction(QAbstractSlider::SliderSingleStepSub);
+            break;
+        case Qt::Key_Down:
+            vbar->triggerAction(QAbstractSlider::SliderSingleStepAdd);
+            break;
+        case Qt::Key_PageUp:
+            vbar->triggerAction(QAbstractSlider::SliderPageStepSub);
+            break;
+        case Qt::Key_PageDown:
+            vbar->triggerAction(QAbstractSlider::SliderPageStepAdd);
+            break;
+        case Qt::Key_Home:
+            vbar->triggerAction(QAbstractSlider::SliderToMinimum);
+            break;
+        case Qt::Key_End:
+            vbar->triggerAction(QAbstractSlider::SliderToMaximum);
+            break;
+        default:
+            QAbstractScrollArea::keyPressEvent(event);
+            return;
+    }
+    event->accept();
+}
+/*************************/
+void HexView::paintEvent(QPaintEvent* /*event*/) {
+    if (data_ == nullptr)
+        return;
+    QPainter painter(viewport());
+    painter.translate(-horizontalScrollBar()->value(), 0);
+
+    const QFontMetrics fm = fontMetrics();
+    const int lineHeight = fm.height();
+    const int charWidth = fm.horizontalAdvance(QLatin1Char('0'));
+    const int hexX = (offsetDigits_ + 2) * charWidth;
+    const int asciiX = hexX + (BYTES_PER_ROW * 3 + 2) * charWidth;
+    const QPalette& pal = palette();
+    auto hexPos = [hexX, charWidth](int j) { return hexX + (j * 3 + (j >= BYTES_PER_ROW / 2 ? 1 : 0)) * charWidth; };
+
+    /* only the visible rows are read from the mapped file */
+    qint64 row = verticalScrollBar()->value();
+    const int rows = visibleRows() + 1;
+    QString hex, ascii;
+    for (int i = 0; i < rows; ++i, ++row) {
+        const qint64 start = row * BYTES_PER_ROW;
+        if (start >= size_)
+            break;
+        const int n = static_cast<int>(qMin<qint64>(BYTES_PER_ROW, size_ - start));
+        const int y = i * lineHeight;
+        const int baseline = y + fm.ascent();
+
+        hex.clear();
+        ascii.clear();
+        for (int j = 0; j < n; ++j) {
+            const uchar b = data_[start + j];
+            if (j == BYTES_PER_ROW / 2)
+                hex += QLatin1Char(' ');
+            hex += hexDigit(b >> 4);
+            hex += hexDigit(b & 0xf);
+            hex += QLatin1Char(' ');
+            ascii += b >= 0x20 && b < 0x7f ? QLatin1Char(static_cast<char>(b)) : QLatin1Char('.');
+        }
+
+        painter.setPen(pal.color(QPalette::PlaceholderText));
+        painter.drawText(0, baseline, QString::number(start, 16).rightJustified(offsetDigits_, QLatin1Char('0')));
+        painter.setPen(pal.color(QPalette::Text));
+        painter.drawText(hexX, baseline, hex);
+        painter.drawText(asciiX, baseline, ascii);
+
+        /* the selected bytes are painted over */
+        const qint64 selFirst = qMax(selStart_, start);
+        const qint64 selLast = qMin(selStart_ + selLength_, start + n);
+        if (selFirst < selLast) {
+            painter.setPen(pal.color(QPalette::HighlightedText));
+            for (qint64 k = selFirst; k < selLast; ++k) {
+                const int j = static_cast<int>(k - start);
+                const uchar b = data_[k];
+                painter.fillRect(QRect(hexPos(j), y, 2 * charWidth, lineHeight), pal.highlight());
+                painter.fillRect(QRect(asciiX + j * charWidth, y, charWidth, lineHeight), pal.highlight());
+                painter.drawText(hexPos(j), baseline, QString(hexDigit(b >> 4)) + hexDigit(b & 0xf));
+                painter.drawText(asciiX + j * charWidth, baseline, QString(ascii.at(j)));
+            }
+        }
+    }
+}
+/*************************/
+void HexView::select(qint64 start, qint64 length) {
+    selStart_ = start;
+    selLength_ = length;
+    const qint64 row = start / BYTES_PER_ROW;
+    const int first = verticalScrollBar()->value();
+    if (row < first || row >= first + visibleRows()) {
+        verticalScrollBar()->setValue(
+            static_cast<int>(qMin<qint64>(qMax<qint64>(0, row - visibleRows() / 2), INT_MAX)));
+    }
+    viewport()->update();
+}
+/*************************/
+void HexView::goToOffset(qint64 offset) {
+    if (data_ == nullptr)
+        return;
+    select(qBound<qint64>(0, offset, size_ - 1), 1);
+}
+/*************************/
+void HexView::find(const QByteArray& pattern, bool forward) {
+    cancelSearch();
+    const qint64 len = pattern.size();
+    if (data_ == nullptr || len == 0 || len > size_) {
+        emit found(-1);
+        return;
+    }
+
+    qint64 from;
+    if (forward)
+        from = selLength_ > 0 ? qMin(selStart_ + 1, size_) : 0;
+    else {
+        const qint64 last = size_ - len;
+        from = selLength_ > 0 ? qMin(selStart_ - 1, last) : last;
+    }
+
+    HexSearcher* searcher =
+        new HexSearcher(reinterpret_cast<const char*>(data_), size_, pattern, from, forward);
+    searcher_ = searcher;
+    connect(searcher, &HexSearcher::progress, this, [this, searcher](int percent) {
+        if (!searcher->isInterruptionRequested())
+            emit searchProgress(percent);
+    });
+    connect(searcher, &HexSearcher::found, this, [this, searcher, len](qint64 offset) {
+        /* the search may have been canceled after the result was sent */
+        if (searcher->isInterruptionRequested())
+            return;
+        if (offset >= 0)
+            select(offset, len);
+        emit found(offset);
+    });
+    connect(searcher, &QThread::finished, searcher, &QObject::deleteLater);
+    searcher->start(QThread::LowPriority);
+}
+/*************************/
+void HexView::cancelSearch() {
+    if (searcher_) {
+        searcher_->requestInterruption();
+        searcher_->wait();  // the mapped bytes may be released after this
+        searcher_ = nullptr;
+    }
+}
+/*************************/
+HexViewer::HexViewer(const QString& fileName, QWidget* parent) : QDialog(parent) {
+    setWindowTitle(tr("Hex View"));
+    setSizeGripEnabled(true);
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    QGridLayout* grid = new QGridLayout;
+    QLabel* label = new QLabel(this);
+    label->setText("<center><b>" + tr("File") + ": </b></center><i>" + fileName.toHtmlEscaped() + "</i>");
+    label->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    label->setWordWrap(true);
+    label->setMargin(5);
+    grid->addWidget(label, 0, 0, 1, 6);
+
+    hexView_ = new HexView(this);
+    grid->addWidget(hexView_, 1, 0, 1, 6);
+
+    grid->addWidget(new QLabel(tr("Offset:")), 2, 0);
+    offsetEdit_ = new LineEdit(this);
+    offsetEdit_->setPlaceholderText(tr("Decimal or 0x-prefixed hex"));
+    offsetEdit_->setClearButtonEnabled(true);
+    connect(offsetEdit_, &QLineEdit::returnPressed, this, &HexViewer::jump);
+    grid->addWidget(offsetEdit_, 2, 1);
+    grid->addWidget(new QLabel(tr("Find:")), 2, 2);
+    findEdit_ = new LineEdit(this);
+    findEdit_->setClearButtonEnabled(true);
+    connect(findEdit_, &QLineEdit::returnPressed, this, &HexViewer::findNext);
+    grid->addWidget(findEdit_, 2, 3);
+    patternCombo_ = new QComboBox(this);
+    patternCombo_->addItem(tr("Hex bytes"));
+    patternCombo_->addItem(tr("Text"));
+    grid->addWidget(patternCombo_, 2, 4);
+
+    prevButton_ = new QPushButton(QIcon::fromTheme("go-up"), QString());
+    prevButton_->setToolTip(tr("Find previous"));
+    connect(prevButton_, &QAbstractButton::clicked, this, &HexViewer::findPrevious);
+    nextButton_ = new QPushButton(QIcon::fromTheme("go-down"), QString());
+    nextButton_->setToolTip(tr("Find next"));
+    connect(nextButton_, &QAbstractButton::clicked, this, &HexViewer::findNext);
+    stopButton_ = new QPushButton(QIcon::fromTheme("process-stop"), QString());
+    stopButton_->setToolTip(tr("Stop finding"));
+    stopButton_->setEnabled(false);
+    connect(stopButton_, &QAbstractButton::clicked, this, &HexViewer::stopFinding);
+    QHBoxLayout* findButtons = new QHBoxLayout;
+    findButtons->setContentsMargins(0, 0, 0, 0);
+    findButtons->addWidget(prevButton_);
+    findButtons->addWidget(nextButton_);
+    findButtons->addWidget(stopButton_);
+    grid->addLayout(findButtons, 2, 5);
+
+    infoLabel_ = new QLabel(this);
+    grid->addWidget(infoLabel_, 3, 0, 1, 5);
+    QPushButton* closeButton = new QPushButton(QIcon::fromTheme("edit-delete"), tr("Close"));
+    connect(closeButton, &QAbstractButton::clicked, this, &QDialog::reject);
+    grid->addWidget(closeButton, 3, 5, Qt::AlignRight);
+    grid->setColumnStretch(3, 1);
+    setLayout(grid);
+
+    connect(hexView_, &HexView::searchProgress, this, [this](int percent) {
+        infoLabel_->setText(tr("Finding...") + QString(" %1%").arg(percent));
+    });
+    connect(hexView_, &HexView::found, this, &HexViewer::onFound);
+
+    if (hexView_->setFile(fileName))
+        infoLabel_->setText(tr("%n byte(s)", "", static_cast<int>(qMin<qint64>(hexView_->size(), INT_MAX))));
+    else {
+        infoLabel_->setText(tr("The file cannot be mapped into memory."));
+        offsetEdit_->setEnabled(false);
+        findEdit_->setEnabled(false);
+    }
+
+    const QFontMetrics fm(hexView_->font());
+    resize(fm.horizontalAdvance(QLatin1Char('0')) * 96, fm.height() * 32);
+}
+/*************************/
+void HexViewer::jump() {
+    const QString str = offsetEdit_->text().trimmed();
+    bool ok = false;
+    const qint64 offset = str.startsWith(QLatin1String("0x"), Qt::CaseInsensitive) ? str.mid(2).toLongLong(&ok, 16)
+                                                                                  : str.toLongLong(&ok, 10);
+    if (!ok || offset < 0 || offset >= hexView_->size()) {
+        infoLabel_->setText(tr("Invalid offset"));
+        return;
+    }
+    hexView_->goToOffset(offset);
+    infoLabel_->setText(tr("Offset") + QString(": 0x%1").arg(offset, 0, 16));
+}
+/*************************/
+void HexViewer::findNext() {
+    find(true);
+}
+/*************************/
+void HexViewer::findPrevious() {
+    find(false);
+}
+/*************************/
+void HexViewer::find(bool forward) {
+    if (stopButton_->isEnabled())  // a search is in progress
+        return;
+    QByteArray pattern;
+    if (patternCombo_->currentIndex() == 0) {
+        QString hex = findEdit_->text();
+        hex.remove(QRegularExpression("\\s"));
+        static const QRegularExpression hexPattern("^([0-9A-Fa-f]{2})+$");
+        if (!hexPattern.match(hex).hasMatch()) {
+            infoLabel_->setText(tr("Invalid hex bytes"));
+            return;
+        }
+        pattern = QByteArray::fromHex(hex.toLatin1());
+    }
+    else
+        pattern = findEdit_->text().toUtf8();
+    if (pattern.isEmpty())
+        return;
+
+    setSearching(true);
+    infoLabel_->setText(tr("Finding..."));
+    hexView_->find(pattern, forward);
+}
+/*************************/
+void HexViewer::onFound(qint64 offset) {
+    setSearching(false);
+    if (offset < 0)
+        infoLabel_->setText(tr("Not found"));
+    else
+        infoLabel_->setText(tr("Found at") + QString(" 0x%1").arg(offset, 0, 16));
+}
+/*************************/
+void HexViewer::stopFinding() {
+    hexView_->cancelSearch();
+    setSearching(false);
+    infoLabel_->setText(tr("Finding stopped"));
+}
+/*************************/
+void HexViewer::setSearching(bool searching) {
+    prevButton_->setEnabled(!searching);
+    nextButton_->setEnabled(!searching);
+    stopButton_->setEnabled(searching);
+}
+
+}  // namespace FeatherPad
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) Pedram Pourang (aka Tsu Jan) 2026 <tsujan2000@gmail.com>
+ *
+ * FeatherPad is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FeatherPad is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @license GPL-3.0+ <https://spdx.org/licenses/GPL-3.0+.html>
+ */
+
+#ifndef HEXVIEW_H
+#define HEXVIEW_H
+
+#include <QDialog>
+#include <QAbstractScrollArea>
+#include <QFile>
+#include <QComboBox>
+#include <QLabel>
+#include <QPointer>
+#include <QPushButton>
+#include <QThread>
+#include "lineedit.h"
+
+namespace FeatherPad {
+
+/* Searches the mapped bytes for a pattern in a separate thread. The bytes are
+   searched in chunks, so that the search can be interrupted between them and
+   its progress can be reported. The mapping should remain valid meanwhile. */
+class HexSearcher : public QThread {
+    Q_OBJECT
+
+   public:
+    /* The search starts at "from" and wraps around. "from" should not be greater
+       than the size with a forward search, or the size minus the pattern length
+       with a backward search (where a negative value means the end). */
+    HexSearcher(const char* data, qint64 size, const QByteArray& pattern, qint64 from, bool forward);
+
+   signals:
+    void progress(int percent);
+    void found(qint64 offset);  // -1 if there is no match
+
+   private:
+    void run() override;
+    qint64 searchForward(qint64 start, qint64 end);
+    qint64 searchBackward(qint64 lowest, qint64 from);
+    void addScanned(qint64 bytes);
+
+    const char* data_;
+    qint64 size_;
+    QByteArray pattern_;
+    qint64 from_;
+    bool forward_;
+    qint64 total_;
+    qint64 scanned_;
+    int percent_;
+};
+
+/* Shows the bytes of a memory-mapped file as rows of hex and ASCII. Only the
+   visible rows are painted, so a file of any size is shown instantly. */
+class HexView : public QAbstractScrollArea {
+    Q_OBJECT
+
+   public:
+    HexView(QWidget* parent = nullptr);
+    ~HexView();
+
+    /* Maps the file and returns false if that isn't possible. */
+    bool setFile(const QString& fileName);
+    qint64 size() const { return size_; }
+
+    void goToOffset(qint64 offset);
+    /* Starts finding the pattern after (or before) the current match, wrapping
+       around, in a separate thread. The match is selected when it is found. */
+    void find(const QByteArray& pattern, bool forward);
+    /* Stops the search, if any, and waits for its thread to finish. */
+    void cancelSearch();
+
+   signals:
+    void searchProgress(int percent);
+    void found(qint64 offset);  // -1 if there is no match
+
+   protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void keyPressEvent(QKeyEvent* event) override;
+    void changeEvent(QEvent* event) override;
+
+   private:
+    void updateScrollBars();
+    int visibleRows() const;
+    void select(qint64 start, qint64 length);
+
+    QFile file_;
+    QPointer<HexSearcher> searcher_;
+    const uchar* data_;
+    qint64 size_;
+    qint64 selStart_;
+    qint64 selLength_;
+    int offsetDigits_;
+};
+
+/* A non-modal dialog with a hex view, an offset field and a search field. */
+class HexViewer : public QDialog {
+    Q_OBJECT
+
+   public:
+    HexViewer(const QString& fileName, QWidget* parent = nullptr);
+
+   private slots:
+    void jump();
+    void findNext();
+    void findPrevious();
+    void stopFinding();
+
+   private:
+    void find(bool forward);
+    void onFound(qint64 offset);
+    void setSearching(bool searching);
+
+    HexView* hexView_;
+    LineEdit* offsetEdit_;
+    LineEdit* findEdit_;
+    QComboBox* patternCombo_;
+    QPushButton* prevButton_;
+    QPushButton* nextButton_;
+    QPushButton* stopButton_;
+    QLabel* infoLabel_;
+};
+
+}  // namespace FeatherPad
+
+#endif  // HEXVIEW_H
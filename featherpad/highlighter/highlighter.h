@@ -95,6 +95,8 @@ class Highlighter : public QSyntaxHighlighter {
         startCursor = start;
         endCursor = end;
     }
+    QTextCursor limitStart() const { return startCursor; }
+    QTextCursor limitEnd() const { return endCursor; }
 
    protected:
     void highlightBlock(const QString& text) override;
@@ -20,7 +20,8 @@
 #include "loading.h"
 #include "encoding.h"
 #include <QFile>
-#include <QStringDecoder>
+
+#define MAX_RAW_CACHE (64 * 1024 * 1024)  // in bytes
 
 namespace FeatherPad {
 
@@ -43,6 +44,15 @@ Loading::Loading(const QString& fname,
 Loading::~Loading() {}
 /*************************/
 void Loading::run() {
+    if (!rawBytes_.isEmpty() && !charset_.isEmpty()) {
+        /* re-decode the bytes that were read before, without
+           any disk access, null check or charset detection */
+        QString text = decodeText(qUncompress(rawBytes_), charset_);
+        emit completed(text, fname_, charset_, true, reload_, restoreCursor_, posInLine_, forceUneditable_, multiple_);
+        return;
+    }
+    rawBytes_.clear();
+
     if (!QFile::exists(fname_)) {
         emit completed(QString(), fname_, charset_.isEmpty() ? "UTF-8" : charset_, false, false, 0, 0, false,
                        multiple_);
@@ -133,6 +143,7 @@ void Loading::run() {
                             if (!hasNull) {
                                 if (skipNonText_) {
                                     file.close();
+                                    emit nonTextSkipped(fname_);
                                     emit completed(QString(), QString(),
                                                    "UTF-8");  // shows that a non-text file is skipped
                                     return;
@@ -154,6 +165,7 @@ void Loading::run() {
                 else {  // the meaning of null characters was determined before
                     if (skipNonText_ && hasNull && charset_.isEmpty()) {
                         file.close();
+                        emit nonTextSkipped(fname_);
                         emit completed(QString(), QString(), "UTF-8");
                         return;
                     }
@@ -173,25 +185,27 @@ void Loading::run() {
     }
     file.close();
     if (skipNonText_ && hasNull && charset_.isEmpty()) {
+        emit nonTextSkipped(fname_);
         emit completed(QString(), QString(), "UTF-8");
         return;
     }
 
+    bool guessed = false;
     if (charset_.isEmpty()) {
         if (hasNull) {
             forceUneditable_ = true;
             charset_ = "UTF-8";  // always open non-text files as UTF-8
         }
-        else
+        else {
             charset_ = detectCharset(data);
+            guessed = true;
+        }
     }
 
-    /* Legacy encodings aren't supported by Qt >= Qt6. */
-    auto decoder = QStringDecoder(charset_ == "UTF-8"    ? QStringConverter::Utf8
-                                  : charset_ == "UTF-16" ? QStringConverter::Utf16
-                                  : charset_ == "UTF-32" ? QStringConverter::Utf32
-                                                         : QStringConverter::Latin1);
-    QString text = decoder.decode(data);
+    QString text = decodeText(data, charset_);
+    /* the encoding is usually changed only when the detected one is wrong */
+    if (guessed && data.size() <= MAX_RAW_CACHE)
+        rawBytes_ = qCompress(data, 1);  // fast compression is good enough for texts
 
     emit completed(text, fname_, charset_, enforced, reload_, restoreCursor_, posInLine_, forceUneditable_, multiple_);
 }
@@ -39,6 +39,12 @@ class Loading : public QThread {
 
     void setSkipNonText(bool skip) { skipNonText_ = skip; }
 
+    /* If compressed raw bytes are set before starting, they are decoded with
+       the enforced charset instead of reading the file. After loading, this
+       returns the compressed bytes that were read (empty for huge files). */
+    void setRawBytes(const QByteArray& rawBytes) { rawBytes_ = rawBytes; }
+    QByteArray rawBytes() const { return rawBytes_; }
+
    signals:
     void completed(const QString& text = QString(),
                    const QString& fname = QString(),
@@ -49,6 +55,8 @@ class Loading : public QThread {
                    int posInLine = 0,
                    bool uneditable = false,
                    bool multiple = false);
+    /* Emitted before "completed" when a non-text file is skipped. */
+    void nonTextSkipped(const QString& fname);
 
    private:
     void run();
@@ -61,6 +69,7 @@ class Loading : public QThread {
     bool forceUneditable_;  // Should the doc be always uneditable? (Only passed.)
     bool multiple_;         // Are there multiple files to load? (Only passed.)
     bool skipNonText_;      // Should non-text files be skipped?
+    QByteArray rawBytes_;   // The compressed bytes of the file.
 };
 
 }  // namespace FeatherPad
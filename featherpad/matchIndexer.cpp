@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) Pedram Pourang (aka Tsu Jan) 2026 <tsujan2000@gmail.com>
+ *
+ * FeatherPad is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FeatherPad is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @license GPL-3.0+ <https://spdx.org/licenses/GPL-3.0+.html>
+ */
+
+#include "matchIndexer.h"
+#include <QRegularExpression>
+
+namespace FeatherPad {
+
+MatchIndexer::MatchIndexer(const DocumentSnapshot& snapshot,
+                           const QString& str,
+                           QTextDocument::FindFlags flags,
+                           bool isRegex)
+    : QThread(), snapshot_(snapshot), str_(str), flags_(flags), isRegex_(isRegex) {}
+/*************************/
+void MatchIndexer::run() {
+    QList<int> blockNumbers;
+    if (!str_.isEmpty()) {
+        const QString text = snapshot_.text();
+        blockNumbers = index(text, str_, flags_, isRegex_, 0, this);
+    }
+    if (!isInterruptionRequested())
+        emit indexed(blockNumbers, snapshot_.revision());
+}
+/*************************/
+static void indexPlainText(QStringView text,
+                           const QString& str,
+                           QTextDocument::FindFlags flags,
+                           int firstBlock,
+                           const QThread* thread,
+                           QList<int>& blockNumbers) {
+    const Qt::CaseSensitivity cs =
+        (flags & QTextDocument::FindCaseSensitively) ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    const bool wholeWords = flags & QTextDocument::FindWholeWords;
+    const qsizetype length = str.length();
+    const qsizetype size = text.size();
+    int block = firstBlock;
+    qsizetype counted = 0;  // the position up to which newlines are counted
+    qsizetype indx = 0;
+    int n = 0;
+    while ((indx = text.indexOf(str, indx, cs)) > -1) {
+        if ((++n & 0xfff) == 0 && thread && thread->isInterruptionRequested())
+            return;
+        const qsizetype end = indx + length;
+        /* the same condition as in QTextDocument::find() */
+        if (wholeWords && ((indx > 0 && text.at(indx - 1).isLetterOrNumber()) ||
+                           (end < size && text.at(end).isLetterOrNumber()))) {
+            ++indx;
+            continue;
+        }
+        block += text.mid(counted, indx - counted).count(QLatin1Char('\n'));
+        counted = indx;
+        if (blockNumbers.isEmpty() || blockNumbers.last() != block)
+            blockNumbers.append(block);
+        indx = end;
+    }
+}
+/*************************/
+static void indexRegex(QStringView text,
+                       const QString& str,
+                       QTextDocument::FindFlags flags,
+                       int firstBlock,
+                       const QThread* thread,
+                       QList<int>& blockNumbers) {
+    const QRegularExpression regex(str, (flags & QTextDocument::FindCaseSensitively)
+                                            ? QRegularExpression::NoPatternOption
+                                            : QRegularExpression::CaseInsensitiveOption);
+    if (!regex.isValid())
+        return;
+    int block = firstBlock;
+    qsizetype start = 0;
+    while (start <= text.size()) {
+        if (((block - firstBlock) & 0xfff) == 0 && thread && thread->isInterruptionRequested())
+            return;
+        qsizetype end = text.indexOf(QLatin1Char('\n'), start);
+        if (end < 0)
+            end = text.size();
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 5, 0))
+        if (regex.matchView(text.mid(start, end - start)).hasMatch())
+#else
+        if (regex.match(text.mid(start, end - start)).hasMatch())
+#endif
+            blockNumbers.append(block);
+        start = end + 1;
+        ++block;
+    }
+}
+/*************************/
+QList<int> MatchIndexer::index(QStringView text,
+                               const QString& str,
+                               QTextDocument::FindFlags flags,
+                               bool isRegex,
+                               int firstBlock,
+                               const QThread* thread) {
+    QList<int> blockNumbers;
+    if (isRegex)
+        indexRegex(text, str, flags, firstBlock, thread, blockNumbers);
+    else
+        indexPlainText(text, str, flags, firstBlock, thread, blockNumbers);
+    return blockNumbers;
+}
+
+}  // namespace FeatherPad
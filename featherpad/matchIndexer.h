@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) Pedram Pourang (aka Tsu Jan) 2026 <tsujan2000@gmail.com>
+ *
+ * FeatherPad is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FeatherPad is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @license GPL-3.0+ <https://spdx.org/licenses/GPL-3.0+.html>
+ */
+
+#ifndef MATCHINDEXER_H
+#define MATCHINDEXER_H
+
+#include <QThread>
+#include <QTextDocument>
+#include "snapshot.h"
+
+namespace FeatherPad {
+
+/* Finds the blocks that contain matches of a search string in a separate
+   thread. The rules are those of TextEdit::finding(): regular expressions
+   are matched inside lines, while a plain text may contain newlines. */
+class MatchIndexer : public QThread {
+    Q_OBJECT
+
+   public:
+    MatchIndexer(const DocumentSnapshot& snapshot, const QString& str, QTextDocument::FindFlags flags, bool isRegex);
+
+    /* Finds the blocks of matches in a text that starts at the block "firstBlock".
+       It's also used in the GUI thread for the blocks that are changed by editing. */
+    static QList<int> index(QStringView text,
+                            const QString& str,
+                            QTextDocument::FindFlags flags,
+                            bool isRegex,
+                            int firstBlock = 0,
+                            const QThread* thread = nullptr);
+
+   signals:
+    void indexed(const QList<int>& blockNumbers, int revision);  // the revision of the snapshot
+
+   private:
+    void run() override;
+
+    DocumentSnapshot snapshot_;
+    QString str_;
+    QTextDocument::FindFlags flags_;
+    bool isRegex_;
+};
+
+}  // namespace FeatherPad
+
+#endif  // MATCHINDEXER_H
@@ -0,0 +1,520 @@
+/*
+ * Copyright (C) Pedram Pourang (aka Tsu Jan) 2026 <tsujan2000@gmail.com>
+ *
+ * FeatherPad is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FeatherPad is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @license GPL-3.0+ <https://spdx.org/licenses/GPL-3.0+.html>
+ */
+
+#include <QGridLayout>
+#include <QRegularExpression>
+#include <QScrollBar>
+#include <QTimerEvent>
+#include "outline.h"
+#include "lineedit.h"
+
+#include <algorithm>
+
+#define POPULATE_INTERVAL 300  // in ms
+#define INCREMENTAL_LIMIT 1000  // more changed blocks than this are parsed in a separate thread
+
+namespace FeatherPad {
+
+static const QStringList cFamily = {"c", "cpp", "java", "dart"};
+
+SymbolExtractor::SymbolExtractor(const DocumentSnapshot& snapshot, const QString& lang, int tabSize)
+    : QThread(), snapshot_(snapshot), lang_(lang), tabSize_(tabSize) {}
+/*************************/
+void SymbolExtractor::run() {
+    QList<symbolInfo> symbols;
+    const QString txt = snapshot_.text();
+    const QStringView text(txt);
+    QString prevLine;
+    int block = 0;
+    qsizetype start = 0;
+    while (start <= text.size()) {
+        if ((block & 0xfff) == 0 && isInterruptionRequested())
+            return;
+        qsizetype end = text.indexOf(QLatin1Char('\n'), start);
+        if (end == -1)
+            end = text.size();
+        const QString line = text.mid(start, end - start).toString();
+        extract(lang_, line, prevLine, block, tabSize_, symbols);
+        prevLine = line;
+        start = end + 1;
+        ++block;
+    }
+    emit extracted(symbols, snapshot_.revision());
+}
+/*************************/
+bool SymbolExtractor::supports(const QString& lang) {
+    static const QStringList langs = {"c",    "cpp",  "java", "dart", "javascript", "qml",    "php",
+                                      "go",   "rust", "python", "ruby", "perl",     "lua",    "sh",
+                                      "tcl",  "cmake", "pascal", "markdown", "reST", "json",  "yaml",
+                                      "toml", "css",  "scss"};
+    return langs.contains(lang);
+}
+/*************************/
+static int indentationOf(const QString& line, int tabSize) {
+    int col = 0;
+    for (const QChar& c : line) {
+        if (c == QLatin1Char(' '))
+            ++col;
+        else if (c == QLatin1Char('\t'))
+            col += tabSize - col % tabSize;
+        else
+            break;
+    }
+    return col;
+}
+/*************************/
+// Finds the symbols defined by a line. Since the parsing is line-based,
+// only the previous line is consulted (for underlined headings).
+void SymbolExtractor::extract(const QString& lang,
+                              const QString& line,
+                              const QString& prevLine,
+                              int blockNumber,
+                              int tabSize,
+                              QList<symbolInfo>& symbols) {
+    if (line.isEmpty())
+        return;
+    const int level = indentationOf(line, tabSize) / tabSize;
+    auto add = [&symbols, blockNumber](const QString& name, int level, int block = -1) {
+        if (!name.isEmpty())
+            symbols.append({name, block < 0 ? blockNumber : block, blockNumber, level});
+    };
+
+    if (lang == "markdown") {
+        static const QRegularExpression heading("^ {0,3}(#{1,6})\\s+(.*?)(?:\\s+#+)?\\s*$");
+        static const QRegularExpression underline("^ {0,3}(=+|-+)\\s*$");
+        QRegularExpressionMatch match = heading.match(line);
+        if (match.hasMatch())
+            add(match.captured(2), match.capturedLength(1) - 1);
+        else if (!prevLine.trimmed().isEmpty() && !prevLine.trimmed().startsWith(QLatin1Char('#')) &&
+                 (match = underline.match(line)).hasMatch()) {
+            add(prevLine.trimmed(), match.captured(1).at(0) == QLatin1Char('=') ? 0 : 1, blockNumber - 1);
+        }
+        return;
+    }
+    if (lang == "reST") {
+        static const QRegularExpression underline("^([=\\-`:'\"~^_*+#<>.])\\1{2,}\\s*$");
+        QRegularExpressionMatch match = underline.match(line);
+        if (match.hasMatch()) {
+            const QString title = prevLine.trimmed();
+            if (!title.isEmpty() && title.length() <= line.trimmed().length() && !underline.match(prevLine).hasMatch()) {
+                static const QString adornments = "=-~^";
+                int l = adornments.indexOf(match.captured(1));
+                add(title, l < 0 ? adornments.size() : l, blockNumber - 1);
+            }
+        }
+        return;
+    }
+    if (lang == "json") {
+        /* only keys whose values are objects or arrays */
+        static const QRegularExpression key("^\\s*\"((?:[^\"\\\\]|\\\\.)*)\"\\s*:\\s*[\\{\\[]");
+        QRegularExpressionMatch match = key.match(line);
+        if (match.hasMatch())
+            add(match.captured(1), indentationOf(line, tabSize) / 2);
+        return;
+    }
+    if (lang == "yaml") {
+        /* top-level keys and keys of mappings or sequences */
+        static const QRegularExpression key(
+            "^(\\s*)(-\\s+)?([^\\s#'\"\\-][^:#]*?|\"[^\"]*\"|'[^']*')\\s*:(?:\\s+(.*))?$");
+        QRegularExpressionMatch match = key.match(line);
+        if (match.hasMatch()) {
+            const QString value = match.captured(4).trimmed();
+            if (value.isEmpty() || value.startsWith(QLatin1Char('#')) ||
+                (match.capturedLength(1) == 0 && match.capturedLength(2) == 0)) {
+                add(match.captured(3), indentationOf(line, tabSize) / 2);
+            }
+        }
+        return;
+    }
+    if (lang == "toml") {
+        static const QRegularExpression table("^\\s*\\[\\[?\\s*([^\\]]+?)\\s*\\]\\]?");
+        QRegularExpressionMatch match = table.match(line);
+        if (match.hasMatch())
+            add(match.captured(1), match.captured(1).count(QLatin1Char('.')));
+        return;
+    }
+    if (lang == "css" || lang == "scss") {
+        static const QRegularExpression rule("^\\s*([^\\s{};/][^{};]*?)\\s*\\{");
+        QRegularExpressionMatch match = rule.match(line);
+        if (match.hasMatch())
+            add(match.captured(1), level);
+        return;
+    }
+    if (lang == "python") {
+        static const QRegularExpression def("^\\s*(?:async\\s+)?(?:def|class)\\s+([A-Za-z_]\\w*)");
+        QRegularExpressionMatch match = def.match(line);
+        if (match.hasMatch())
+            add(match.captured(1), level);
+        return;
+    }
+    if (lang == "ruby") {
+        static const QRegularExpression def("^\\s*(?:def|class|module)\\s+([\\w.:?!=<>\\[\\]+\\-]+)");
+        QRegularExpressionMatch match = def.match(line);
+        if (match.hasMatch())
+            add(match.captured(1), level);
+        return;
+    }
+    if (lang == "perl") {
+        static const QRegularExpression sub("^\\s*(?:sub|package)\\s+([\\w:]+)");
+        QRegularExpressionMatch match = sub.match(line);
+        if (match.hasMatch())
+            add(match.captured(1), level);
+        return;
+    }
+    if (lang == "lua") {
+        static const QRegularExpression func(
+            "^\\s*(?:local\\s+)?(?:function\\s+([\\w.:]+)|([\\w.:]+)\\s*=\\s*function\\b)");
+        QRegularExpressionMatch match = func.match(line);
+        if (match.hasMatch())
+            add(match.capturedLength(1) > 0 ? match.captured(1) : match.captured(2), level);
+        return;
+    }
+    if (lang == "sh") {
+        static const QRegularExpression func(
+            "^\\s*(?:function\\s+([\\w.:\\-]+)(?:\\s*\\(\\s*\\))?|([\\w.:\\-]+)\\s*\\(\\s*\\))\\s*\\{?\\s*$");
+        QRegularExpressionMatch match = func.match(line);
+        if (match.hasMatch())
+            add(match.capturedLength(1) > 0 ? match.captured(1) : match.captured(2), level);
+        return;
+    }
+    if (lang == "tcl") {
+        static const QRegularExpression proc("^\\s*proc\\s+(\\S+)");
+        QRegularExpressionMatch match = proc.match(line);
+        if (match.hasMatch())
+            add(match.captured(1), level);
+        return;
+    }
+    if (lang == "cmake") {
+        static const QRegularExpression func("^\\s*(?:function|macro)\\s*\\(\\s*([\\w.\\-]+)",
+                                             QRegularExpression::CaseInsensitiveOption);
+        QRegularExpressionMatch match = func.match(line);
+        if (match.hasMatch())
+            add(match.captured(1), level);
+        return;
+    }
+    if (lang == "pascal") {
+        static const QRegularExpression func(
+            "^\\s*(?:class\\s+)?(?:procedure|function|constructor|destructor)\\s+([\\w.]+)",
+            QRegularExpression::CaseInsensitiveOption);
+        QRegularExpressionMatch match = func.match(line);
+        if (match.hasMatch())
+            add(match.captured(1), level);
+        return;
+    }
+    if (lang == "go") {
+        static const QRegularExpression func("^(?:func\\s+(?:\\([^)]*\\)\\s*)?|type\\s+)([A-Za-z_]\\w*)");
+        QRegularExpressionMatch match = func.match(line);
+        if (match.hasMatch())
+            add(match.captured(1), level);
+        return;
+    }
+    if (lang == "rust") {
+        static const QRegularExpression item(
+            "^\\s*(?:pub(?:\\([^)]*\\))?\\s+)?(?:(?:async|const|unsafe|extern\\s+\"[^\"]*\")\\s+)*"
+            "(fn|struct|enum|trait|impl|mod|union)\\b\\s*([^{;(=]*)");
+        QRegularExpressionMatch match = item.match(line);
+        if (match.hasMatch()) {
+            const QString name = match.captured(2).trimmed();
+            if (!name.isEmpty())
+                add(match.captured(1) == "fn" ? name : match.captured(1) + " " + name, level);
+        }
+        return;
+    }
+
+    /* types of C-like languages */
+    static const QRegularExpression type(
+        "^\\s*(?:template\\s*<.*>\\s*)?(?:(?:public|private|protected|static|final|abstract|export|default|sealed)"
+        "\\s+)*(?:class|struct|union|namespace|interface|enum(?:\\s+class)?|record)\\s+([A-Za-z_$][\\w$]*)[^;]*$");
+    QRegularExpressionMatch match = type.match(line);
+    if (match.hasMatch()) {
+        add(match.captured(1), level);
+        return;
+    }
+    if (lang == "javascript" || lang == "qml" || lang == "php") {
+        static const QRegularExpression func("\\bfunction\\s*\\*?\\s*([A-Za-z_$][\\w$]*)\\s*\\(");
+        match = func.match(line);
+        if (match.hasMatch())
+            add(match.captured(1), level);
+        return;
+    }
+    if (cFamily.contains(lang)) {
+        /* a function definition has a return type or a qualified name,
+           and its first line doesn't end with a semicolon */
+        static const QRegularExpression func("^\\s*((?:[\\w:<>,\\*&]+[\\s\\*&]+)*)([A-Za-z_~][\\w:~]*)\\s*\\([^;]*$");
+        static const QStringList keywords = {"if",     "else", "for",   "while", "switch", "return",
+                                             "do",     "case", "delete", "new",  "throw",  "catch",
+                                             "goto",   "sizeof", "emit", "using", "co_return"};
+        match = func.match(line);
+        if (match.hasMatch()) {
+            const QString name = match.captured(2);
+            const QString returnType = match.captured(1).trimmed();
+            if ((!returnType.isEmpty() || name.contains(QLatin1String("::"))) && !keywords.contains(name) &&
+                !keywords.contains(returnType.section(QLatin1Char(' '), 0, 0))) {
+                add(name, level);
+            }
+        }
+    }
+}
+/*************************/
+OutlinePane::OutlinePane(QWidget* parent) : QWidget(parent) {
+    blockCount_ = revision_ = 0;
+    extracting_ = outdated_ = false;
+    populateTimerId_ = 0;
+
+    QGridLayout* mainGrid = new QGridLayout;
+    mainGrid->setVerticalSpacing(4);
+    mainGrid->setContentsMargins(0, 0, 0, 0);
+    lw_ = new QListWidget(this);
+    lw_->setSelectionMode(QAbstractItemView::SingleSelection);
+    lw_->setUniformItemSizes(true);  // for a fast layout with many symbols
+    mainGrid->addWidget(lw_, 0, 0);
+    le_ = new LineEdit(this);
+    le_->setPlaceholderText(tr("Filter..."));
+    mainGrid->addWidget(le_, 1, 0);
+    setLayout(mainGrid);
+
+    connect(lw_, &QListWidget::itemActivated, this, &OutlinePane::jumpToSymbol);
+    connect(lw_, &QListWidget::itemClicked, this, &OutlinePane::jumpToSymbol);
+    connect(le_, &QLineEdit::textChanged, this, [this](const QString& str) {
+        for (int i = 0; i < lw_->count(); ++i) {
+            QListWidgetItem* item = lw_->item(i);
+            item->setHidden(!item->text().contains(str, Qt::CaseInsensitive));
+        }
+    });
+}
+/*************************/
+QString OutlinePane::language() const {
+    if (!textEdit_)
+        return QString();
+    return textEdit_->getLang().isEmpty() ? textEdit_->getProg() : textEdit_->getLang();
+}
+/*************************/
+int OutlinePane::tabSize() const {
+    return textEdit_ ? std::max(static_cast<int>(textEdit_->getTextTab_().size()), 1) : 4;
+}
+/*************************/
+void OutlinePane::setTextEdit(TextEdit* textEdit) {
+    if (textEdit == textEdit_) {
+        refresh();
+        return;
+    }
+    if (textEdit_)
+        disconnect(textEdit_->document(), &QTextDocument::contentsChange, this, &OutlinePane::onContentsChange);
+    textEdit_ = textEdit;
+    lang_ = language();
+    symbols_.clear();
+    if (textEdit_) {
+        blockCount_ = textEdit_->document()->blockCount();
+        revision_ = textEdit_->document()->revision();
+        connect(textEdit_->document(), &QTextDocument::contentsChange, this, &OutlinePane::onContentsChange);
+    }
+    extractAll();
+}
+/*************************/
+void OutlinePane::refresh() {
+    const QString lang = language();
+    if (lang == lang_)
+        return;
+    lang_ = lang;
+    symbols_.clear();
+    extractAll();
+}
+/*************************/
+void OutlinePane::extractAll() {
+    if (extracting_) {
+        /* the running extractor will be followed by another one */
+        outdated_ = true;
+        return;
+    }
+    if (!textEdit_ || !SymbolExtractor::supports(lang_)) {
+        symbols_.clear();
+        populate();
+        return;
+    }
+    extracting_ = true;
+    outdated_ = false;
+    SymbolExtractor* extractor = new SymbolExtractor(textEdit_->snapshot(), lang_, tabSize());
+    connect(extractor, &SymbolExtractor::extracted, this, [this](const QList<symbolInfo>& symbols, int revision) {
+        if (!outdated_ && textEdit_ && revision == textEdit_->snapshotRevision()) {
+            symbols_ = symbols;
+            populate();
+        }
+    });
+    connect(extractor, &QThread::finished, this, [this] {
+        extracting_ = false;
+        if (outdated_)
+            extractAll();
+    });
+    connect(extractor, &QThread::finished, extractor, &QObject::deleteLater);
+    connect(this, &QObject::destroyed, extractor, &QThread::requestInterruption);
+    extractor->start();
+}
+/*************************/
+// Only the changed blocks (and the block after them, whose heading may
+// depend on the previous line) are parsed again, and the symbols after
+// them are shifted. Large changes are parsed in a separate thread.
+void OutlinePane::onContentsChange(int position, int charsRemoved, int charsAdded) {
+    if (!textEdit_)
+        return;
+    QTextDocument* doc = textEdit_->document();
+    /* the highlighter changes formats with equal numbers of removed and added characters */
+    if (charsRemoved == charsAdded && doc->revision() == revision_)
+        return;
+    revision_ = doc->revision();
+    const int diff = doc->blockCount() - blockCount_;
+    blockCount_ = doc->blockCount();
+    if (extracting_) {
+        outdated_ = true;
+        return;
+    }
+    if (!SymbolExtractor::supports(lang_))
+        return;
+
+    const QTextBlock first = doc->findBlock(position);
+    QTextBlock last = doc->findBlock(position + charsAdded);
+    if (!first.isValid()) {
+        extractAll();
+        return;
+    }
+    if (!last.isValid())
+        last = doc->lastBlock();
+    const int firstNumber = first.blockNumber();
+    const int lastNumber = last.blockNumber();
+    if (lastNumber - firstNumber > INCREMENTAL_LIMIT) {
+        extractAll();
+        return;
+    }
+    const int oldLastNumber = lastNumber - diff;
+
+    QList<symbolInfo> newSymbols;
+    const int tab = tabSize();
+    QString prevLine = first.previous().isValid() ? first.previous().text() : QString();
+    QTextBlock block = first;
+    while (block.isValid() && block.blockNumber() <= lastNumber + 1) {
+        const QString text = block.text();
+        SymbolExtractor::extract(lang_, text, prevLine, block.blockNumber(), tab, newSymbols);
+        prevLine = text;
+        block = block.next();
+    }
+
+    auto it = std::lower_bound(symbols_.begin(), symbols_.end(), firstNumber,
+                               [](const symbolInfo& s, int n) { return s.source < n; });
+    auto end = std::lower_bound(it, symbols_.end(), oldLastNumber + 2,
+                                [](const symbolInfo& s, int n) { return s.source < n; });
+    const qsizetype index = it - symbols_.begin();
+    symbols_.remove(index, end - it);
+    if (diff != 0) {
+        for (qsizetype i = index; i < symbols_.size(); ++i) {
+            symbols_[i].block += diff;
+            symbols_[i].source += diff;
+        }
+    }
+    for (qsizetype i = 0; i < newSymbols.size(); ++i)
+        symbols_.insert(index + i, newSymbols.at(i));
+
+    if (populateTimerId_)
+        killTimer(populateTimerId_);
+    populateTimerId_ = startTimer(POPULATE_INTERVAL);
+}
+/*************************/
+void OutlinePane::timerEvent(QTimerEvent* event) {
+    QWidget::timerEvent(event);
+    if (event->timerId() == populateTimerId_) {
+        killTimer(populateTimerId_);
+        populateTimerId_ = 0;
+        populate();
+    }
+}
+/*************************/
+// Only the items of changed symbols are replaced. The items of the symbols
+// after them are kept, and only their lines are updated if needed.
+void OutlinePane::populate() {
+    if (populateTimerId_) {
+        killTimer(populateTimerId_);
+        populateTimerId_ = 0;
+    }
+    auto sameSymbol = [](const symbolInfo& a, const symbolInfo& b) {
+        return a.level == b.level && a.name == b.name;
+    };
+    const qsizetype oldCount = shown_.size();
+    const qsizetype newCount = symbols_.size();
+    qsizetype prefix = 0;
+    while (prefix < oldCount && prefix < newCount && sameSymbol(shown_.at(prefix), symbols_.at(prefix)) &&
+           shown_.at(prefix).block == symbols_.at(prefix).block) {
+        ++prefix;
+    }
+    qsizetype suffix = 0;
+    while (suffix < oldCount - prefix && suffix < newCount - prefix &&
+           sameSymbol(shown_.at(oldCount - 1 - suffix), symbols_.at(newCount - 1 - suffix))) {
+        ++suffix;
+    }
+    if (prefix == oldCount && prefix == newCount)
+        return;
+
+    const int scrollValue = lw_->verticalScrollBar()->value();
+    const QString filter = le_->text();
+    lw_->setUpdatesEnabled(false);
+    /* update the lines of the kept items after the changed ones (they may be shifted) */
+    for (qsizetype i = 0; i < suffix; ++i) {
+        const symbolInfo& symbol = symbols_.at(newCount - 1 - i);
+        if (shown_.at(oldCount - 1 - i).block != symbol.block)
+            setItem(lw_->item(static_cast<int>(oldCount - 1 - i)), symbol);
+    }
+    /* replace the changed items */
+    if (prefix == 0 && suffix == 0)
+        lw_->clear();
+    else {
+        const int row = static_cast<int>(prefix);
+        for (qsizetype i = prefix; i < oldCount - suffix; ++i)
+            delete lw_->takeItem(row);
+    }
+    for (qsizetype i = prefix; i < newCount - suffix; ++i) {
+        const symbolInfo& symbol = symbols_.at(i);
+        QListWidgetItem* item = new QListWidgetItem;
+        setItem(item, symbol);
+        lw_->insertItem(static_cast<int>(i), item);
+        if (!filter.isEmpty() && !symbol.name.contains(filter, Qt::CaseInsensitive))
+            item->setHidden(true);
+    }
+    shown_ = symbols_;
+    lw_->verticalScrollBar()->setValue(scrollValue);
+    lw_->setUpdatesEnabled(true);
+}
+/*************************/
+void OutlinePane::setItem(QListWidgetItem* item, const symbolInfo& symbol) const {
+    QLocale l = locale();
+    l.setNumberOptions(QLocale::OmitGroupSeparator);
+    item->setText(QString(2 * std::min(symbol.level, 20), QLatin1Char(' ')) + symbol.name);
+    item->setData(Qt::UserRole, symbol.block);
+    item->setToolTip(tr("Line %1").arg(l.toString(symbol.block + 1)));
+}
+/*************************/
+void OutlinePane::jumpToSymbol(QListWidgetItem* item) {
+    if (!textEdit_ || !item)
+        return;
+    QTextBlock block = textEdit_->document()->findBlockByNumber(item->data(Qt::UserRole).toInt());
+    if (!block.isValid())
+        return;
+    QTextCursor cur(block);
+    textEdit_->setTextCursor(cur);
+    textEdit_->centerCursor();
+    textEdit_->setFocus();
+}
+
+}  // namespace FeatherPad
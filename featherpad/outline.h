@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) Pedram Pourang (aka Tsu Jan) 2026 <tsujan2000@gmail.com>
+ *
+ * FeatherPad is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FeatherPad is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @license GPL-3.0+ <https://spdx.org/licenses/GPL-3.0+.html>
+ */
+
+#ifndef OUTLINE_H
+#define OUTLINE_H
+
+#include <QThread>
+#include <QPointer>
+#include <QListWidget>
+#include "textedit.h"
+#include "snapshot.h"
+
+namespace FeatherPad {
+
+class LineEdit;
+
+struct symbolInfo {
+    QString name;
+    int block;   // the block to jump to
+    int source;  // the block that defines the symbol (it's the underline of some headings)
+    int level;   // for indenting the symbol in the outline
+};
+
+/* Extracts the symbols of a whole text in a separate thread. The parsing is
+   line-based and lightweight; it is also used for updating the outline when
+   a few blocks are changed. */
+class SymbolExtractor : public QThread {
+    Q_OBJECT
+
+   public:
+    SymbolExtractor(const DocumentSnapshot& snapshot, const QString& lang, int tabSize);
+
+    static bool supports(const QString& lang);
+    static void extract(const QString& lang,
+                        const QString& line,
+                        const QString& prevLine,
+                        int blockNumber,
+                        int tabSize,
+                        QList<symbolInfo>& symbols);
+
+   signals:
+    void extracted(const QList<FeatherPad::symbolInfo>& symbols, int revision);  // the revision of the snapshot
+
+   private:
+    void run() override;
+
+    DocumentSnapshot snapshot_;
+    QString lang_;
+    int tabSize_;
+};
+
+class OutlinePane : public QWidget {
+    Q_OBJECT
+
+   public:
+    OutlinePane(QWidget* parent = nullptr);
+
+    /* The outline follows the document of this text edit (nothing if it's null). */
+    void setTextEdit(TextEdit* textEdit);
+    /* Called when the language of the document may have changed. */
+    void refresh();
+
+   protected:
+    void timerEvent(QTimerEvent* event) override;
+
+   private slots:
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
+    void jumpToSymbol(QListWidgetItem* item);
+
+   private:
+    void extractAll();
+    void populate();
+    void setItem(QListWidgetItem* item, const symbolInfo& symbol) const;
+    QString language() const;
+    int tabSize() const;
+
+    QListWidget* lw_;
+    LineEdit* le_;
+    QPointer<TextEdit> textEdit_;
+    QString lang_;
+    int blockCount_;
+    int revision_;               // for telling text changes from format changes
+    QList<symbolInfo> symbols_;  // sorted by their sources
+    QList<symbolInfo> shown_;    // the symbols of the list items
+    bool extracting_;
+    bool outdated_;  // whether the running extractor works on an old text
+    int populateTimerId_;
+};
+
+}  // namespace FeatherPad
+
+#endif  // OUTLINE_H
@@ -124,6 +124,7 @@ PrefDialog::PrefDialog(QWidget* parent) : QDialog(parent), ui(new Ui::PrefDialog
     saveUnmodified_ = config.getSaveUnmodified();
     sharedSearchHistory_ = config.getSharedSearchHistory();
     selHighlighting_ = config.getSelectionHighlighting();
+    documentOverview_ = config.getDocumentOverview();
     pastePaths_ = config.getPastePaths();
     whiteSpaceValue_ = config.getWhiteSpaceValue();
     curLineHighlight_ = config.getCurLineHighlight();
@@ -291,6 +292,8 @@ PrefDialog::PrefDialog(QWidget* parent) : QDialog(parent), ui(new Ui::PrefDialog
 
     ui->selHighlightBox->setChecked(selHighlighting_);
 
+    ui->overviewBox->setChecked(documentOverview_);
+
     ui->dateEdit->setText(config.getDateFormat());
 
     ui->lastLineBox->setChecked(config.getAppendEmptyLine());
@@ -573,6 +576,7 @@ void PrefDialog::onClosing() {
     prefSaveUnmodified();
     prefThickCursor();
     prefSelHighlight();
+    prefDocumentOverview();
     prefPastePaths();
 
     Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
@@ -580,8 +584,17 @@ void PrefDialog::onClosing() {
     config.writeConfig();
 }
 /*************************/
+// The per-tab preferences are applied to the current tab of each window and
+// to other tabs only when they become current (see FPwin::applyPrefs).
+void PrefDialog::updateTabs() {
+    FPsingleton* singleton = static_cast<FPsingleton*>(qApp);
+    singleton->outdatePrefs();
+    for (int i = 0; i < singleton->Wins.count(); ++i)
+        singleton->Wins.at(i)->applyPrefsToCurrentTab();
+}
+/*************************/
 void PrefDialog::showPrompt(const QString& str, bool temporary) {
-    Config config = static_cast<FPsingleton*>(qApp)->getConfig();
+    const Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
     if (!str.isEmpty()) {  // show the provided message
         ui->promptLabel->setText("<b>" + str + "</b>");
         if (temporary)  // show it temporarily
@@ -786,7 +799,7 @@ void PrefDialog::prefStatusbar(int checked) {
                         connect(thisTextEdit, &QPlainTextEdit::blockCountChanged, win, &FPwin::statusMsgWithLineCount);
                         connect(thisTextEdit, &TextEdit::selChanged, win, &FPwin::statusMsg);
                         if (showCurPos)
-                            connect(thisTextEdit, &QPlainTextEdit::cursorPositionChanged, win, &FPwin::showCursorPos);
+                            connect(thisTextEdit, &TextEdit::cursorMoved, win, &FPwin::showCursorPos);
                     }
                     win->ui->statusBar->setVisible(true);
                     if (showCurPos) {
@@ -826,7 +839,7 @@ void PrefDialog::prefStatusCursor(int checked) {
                 win->showCursorPos();
                 for (int j = 0; j < count; ++j) {
                     TextEdit* textEdit = qobject_cast<TabPage*>(win->ui->tabWidget->widget(j))->textEdit();
-                    connect(textEdit, &QPlainTextEdit::cursorPositionChanged, win, &FPwin::showCursorPos);
+                    connect(textEdit, &TextEdit::cursorMoved, win, &FPwin::showCursorPos);
                 }
             }
         }
@@ -835,12 +848,12 @@ void PrefDialog::prefStatusCursor(int checked) {
         config.setShowCursorPos(false);
         for (int i = 0; i < singleton->Wins.count(); ++i) {
             FPwin* win = singleton->Wins.at(i);
-            if (QLabel* posLabel = win->ui->statusBar->findChild<QLabel*>("posLabel")) {
+            if (StatusSegment* posLabel = win->ui->statusBar->findChild<StatusSegment*>("posLabel")) {
                 int count = win->ui->tabWidget->count();
                 if (count > 0 && win->ui->statusBar->isVisible()) {
                     for (int j = 0; j < count; ++j) {
                         TextEdit* textEdit = qobject_cast<TabPage*>(win->ui->tabWidget->widget(j))->textEdit();
-                        disconnect(textEdit, &QPlainTextEdit::cursorPositionChanged, win, &FPwin::showCursorPos);
+                        disconnect(textEdit, &TextEdit::cursorMoved, win, &FPwin::showCursorPos);
                     }
                 }
                 posLabel->deleteLater();
@@ -894,63 +907,33 @@ void PrefDialog::prefIndent(int checked) {
 }
 /*************************/
 void PrefDialog::prefAutoBracket(int checked) {
-    FPsingleton* singleton = static_cast<FPsingleton*>(qApp);
-    Config& config = singleton->getConfig();
+    Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
     if (checked == Qt::Checked) {
         if (!config.getAutoBracket()) {
             config.setAutoBracket(true);
-            for (int i = 0; i < singleton->Wins.count(); ++i) {
-                int count = singleton->Wins.at(i)->ui->tabWidget->count();
-                for (int j = 0; j < count; ++j) {
-                    qobject_cast<TabPage*>(singleton->Wins.at(i)->ui->tabWidget->widget(j))
-                        ->textEdit()
-                        ->setAutoBracket(true);
-                }
-            }
+            updateTabs();
         }
     }
     else if (checked == Qt::Unchecked) {
         if (config.getAutoBracket()) {
             config.setAutoBracket(false);
-            for (int i = 0; i < singleton->Wins.count(); ++i) {
-                int count = singleton->Wins.at(i)->ui->tabWidget->count();
-                for (int j = 0; j < count; ++j) {
-                    qobject_cast<TabPage*>(singleton->Wins.at(i)->ui->tabWidget->widget(j))
-                        ->textEdit()
-                        ->setAutoBracket(false);
-                }
-            }
+            updateTabs();
         }
     }
 }
 /*************************/
 void PrefDialog::prefAutoReplace(int checked) {
-    FPsingleton* singleton = static_cast<FPsingleton*>(qApp);
-    Config& config = singleton->getConfig();
+    Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
     if (checked == Qt::Checked) {
         if (!config.getAutoReplace()) {
             config.setAutoReplace(true);
-            for (int i = 0; i < singleton->Wins.count(); ++i) {
-                int count = singleton->Wins.at(i)->ui->tabWidget->count();
-                for (int j = 0; j < count; ++j) {
-                    qobject_cast<TabPage*>(singleton->Wins.at(i)->ui->tabWidget->widget(j))
-                        ->textEdit()
-                        ->setAutoReplace(true);
-                }
-            }
+            updateTabs();
         }
     }
     else if (checked == Qt::Unchecked) {
         if (config.getAutoReplace()) {
             config.setAutoReplace(false);
-            for (int i = 0; i < singleton->Wins.count(); ++i) {
-                int count = singleton->Wins.at(i)->ui->tabWidget->count();
-                for (int j = 0; j < count; ++j) {
-                    qobject_cast<TabPage*>(singleton->Wins.at(i)->ui->tabWidget->widget(j))
-                        ->textEdit()
-                        ->setAutoReplace(false);
-                }
-            }
+            updateTabs();
         }
     }
 }
@@ -999,20 +982,16 @@ void PrefDialog::prefApplySyntax() {
 }
 /*************************/
 void PrefDialog::prefApplyDateFormat() {
-    FPsingleton* singleton = static_cast<FPsingleton*>(qApp);
-    Config& config = singleton->getConfig();
+    Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
     QString format = ui->dateEdit->text();
     /* if "\n" is typed in the line-edit, interpret
        it as a newline because we're on Linux */
     if (!format.isEmpty())
         format.replace("\\n", "\n");
+    if (format == config.getDateFormat())
+        return;
     config.setDateFormat(format);
-    for (int i = 0; i < singleton->Wins.count(); ++i) {
-        int count = singleton->Wins.at(i)->ui->tabWidget->count();
-        for (int j = 0; j < count; ++j) {
-            qobject_cast<TabPage*>(singleton->Wins.at(i)->ui->tabWidget->widget(j))->textEdit()->setDateFormat(format);
-        }
-    }
+    updateTabs();
 }
 /*************************/
 void PrefDialog::prefWhiteSpace(int checked) {
@@ -1157,53 +1136,39 @@ void PrefDialog::prefColValue(int value) {
 }
 /*************************/
 void PrefDialog::prefThickCursor() {
-    FPsingleton* singleton = static_cast<FPsingleton*>(qApp);
-    Config& config = singleton->getConfig();
+    Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
     bool thick(ui->thickCursorBox->isChecked());
+    if (thick == config.getThickCursor())
+        return;
     config.setThickCursor(thick);
-    for (int i = 0; i < singleton->Wins.count(); ++i) {
-        int count = singleton->Wins.at(i)->ui->tabWidget->count();
-        for (int j = 0; j < count; ++j) {
-            TextEdit* textedit = qobject_cast<TabPage*>(singleton->Wins.at(i)->ui->tabWidget->widget(j))->textEdit();
-            if (j == 0 && textedit->getThickCursor() == thick)
-                return;
-            textedit->setThickCursor(thick);
-        }
-    }
+    updateTabs();
 }
 /*************************/
 void PrefDialog::prefSelHighlight() {
     bool selHighlighting = ui->selHighlightBox->isChecked();
     if (selHighlighting == selHighlighting_)
         return;
-    FPsingleton* singleton = static_cast<FPsingleton*>(qApp);
-    Config& config = singleton->getConfig();
+    Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
     config.setSelectionHighlighting(selHighlighting);
-    for (int i = 0; i < singleton->Wins.count(); ++i) {
-        int count = singleton->Wins.at(i)->ui->tabWidget->count();
-        for (int j = 0; j < count; ++j) {
-            qobject_cast<TabPage*>(singleton->Wins.at(i)->ui->tabWidget->widget(j))
-                ->textEdit()
-                ->setSelectionHighlighting(selHighlighting);
-        }
-    }
+    updateTabs();
+}
+/*************************/
+void PrefDialog::prefDocumentOverview() {
+    bool overview = ui->overviewBox->isChecked();
+    if (overview == documentOverview_)
+        return;
+    Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
+    config.setDocumentOverview(overview);
+    updateTabs();
 }
 /*************************/
 void PrefDialog::prefPastePaths() {
     bool pastePaths = ui->pastePathsBox->isChecked();
     if (pastePaths == pastePaths_)
         return;
-    FPsingleton* singleton = static_cast<FPsingleton*>(qApp);
-    Config& config = singleton->getConfig();
+    Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
     config.setPastePaths(pastePaths);
-    for (int i = 0; i < singleton->Wins.count(); ++i) {
-        int count = singleton->Wins.at(i)->ui->tabWidget->count();
-        for (int j = 0; j < count; ++j) {
-            qobject_cast<TabPage*>(singleton->Wins.at(i)->ui->tabWidget->widget(j))
-                ->textEdit()
-                ->setPastePaths(pastePaths);
-        }
-    }
+    updateTabs();
 }
 /*************************/
 void PrefDialog::prefAppendEmptyLine(int checked) {
@@ -1400,7 +1365,7 @@ void PrefDialog::prefSplitterPos(int checked) {
 /*************************/
 // NOTE: Custom shortcuts will be saved in the PortableText format.
 void PrefDialog::onShortcutChange(QTableWidgetItem* item) {
-    Config config = static_cast<FPsingleton*>(qApp)->getConfig();
+    const Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
     QString desc = ui->tableWidget->item(ui->tableWidget->currentRow(), 0)->text();
 
     QString txt = item->text();
@@ -135,13 +135,15 @@ class PrefDialog : public QDialog {
     void prefApplyDateFormat();
     void prefThickCursor();
     void prefSelHighlight();
+    void prefDocumentOverview();
     void prefPastePaths();
+    void updateTabs();
     void showPrompt(const QString& str = QString(), bool temporary = false);
 
     Ui::PrefDialog* ui;
     QWidget* parent_;
     bool darkBg_, showWhiteSpace_, showEndings_, textMargin_, saveUnmodified_, sharedSearchHistory_, selHighlighting_,
-        pastePaths_, disableMenubarAccel_, sysIcons_;
+        documentOverview_, pastePaths_, disableMenubarAccel_, sysIcons_;
     int vLineDistance_, darkColValue_, lightColValue_, recentNumber_, textTabSize_, whiteSpaceValue_, curLineHighlight_;
     QHash<QString, QString> shortcuts_, newShortcuts_;
     QString prevtMsg_;
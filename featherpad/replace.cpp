@@ -19,6 +19,7 @@
 
 #include "fpwin.h"
 #include "ui_fp.h"
+#include "vscrollbar.h"
 
 namespace FeatherPad {
 
@@ -42,6 +43,7 @@ void FPwin::removeGreenSel() {
             es.prepend(textEdit->currentLineSelection());
         textEdit->setGreenSel(QList<QTextEdit::ExtraSelection>());
         textEdit->setExtraSelections(es);
+        textEdit->vScrollBar()->clearMarkers(VScrollBar::ReplaceMarker);
     }
 }
 /*************************/
@@ -101,6 +103,7 @@ void FPwin::replace() {
     TextEdit* textEdit = tabPage->textEdit();
     if (textEdit->isReadOnly())
         return;
+    textEdit->keepSelectionData();
 
     textEdit->setReplaceTitle(QString());
     ui->dockReplace->setWindowTitle(tr("Replacement"));
@@ -193,6 +196,7 @@ void FPwin::replaceAll() {
     TextEdit* textEdit = tabPage->textEdit();
     if (textEdit->isReadOnly())
         return;
+    textEdit->keepSelectionData();
 
     QString txtFind = ui->lineEditFind->text();
     if (txtFind.isEmpty())
@@ -220,39 +224,76 @@ void FPwin::replaceAll() {
     orig.setPosition(orig.anchor());
     textEdit->setTextCursor(orig);
     QColor color = QColor(textEdit->hasDarkScheme() ? Qt::darkGreen : Qt::green);
-    int pos;
     QTextCursor found;
     QTextCursor start = orig;
-    start.beginEditBlock();
     start.setPosition(0);
-    QTextCursor tmp = start;
     int count = 0;
     QTextEdit::ExtraSelection extra;
     extra.format.setBackground(color);
 
     makeBusy();
+    /* first, find all matches with their replacements... */
+    struct replacement {
+        int start;
+        int end;
+        QString text;
+    };
+    QList<replacement> replacements;
     while (!(found = textEdit->finding(txtFind, start, searchFlags, tabPage->matchRegex())).isNull()) {
-        start.setPosition(found.anchor());
-        pos = found.anchor();
-        start.setPosition(found.position(), QTextCursor::KeepAnchor);
-        if (tabPage->matchRegex())
-            start.insertText(found.selectedText().replace(regexFind, txtReplace));
-        else
-            start.insertText(txtReplace);
+        replacements.append({found.anchor(), found.position(),
+                             tabPage->matchRegex() ? found.selectedText().replace(regexFind, txtReplace)
+                                                   : txtReplace});
+        /* don't stay on an empty match */
+        start.setPosition(found.position() > found.anchor() ? found.position() : found.position() + 1);
+        if (start.position() == found.anchor())  // the end of the document
+            break;
+    }
 
-        if (count < 1000) {
-            tmp.setPosition(pos);
-            tmp.setPosition(start.position(), QTextCursor::KeepAnchor);
+    /* ... then, replace the text from the first match to the last one as a single
+       edit, to have a single undo command, and highlight the first 1000 replacements */
+    if (!replacements.isEmpty()) {
+        const int spanStart = replacements.first().start;
+        const int spanEnd = replacements.last().end;
+        QTextCursor tmp = start;
+        tmp.setPosition(spanStart);
+        tmp.setPosition(spanEnd, QTextCursor::KeepAnchor);
+        const QString spanText = tmp.selectedText();
+        QString newText;
+        QList<std::pair<int, int>> replaced;  // start and length in the new text
+        /* block numbers of replacements for the overview (counted by paragraph separators) */
+        const bool overview = textEdit->vScrollBar()->hasOverview();
+        const int firstBlock = overview ? textEdit->document()->findBlock(spanStart).blockNumber() : 0;
+        int separators = 0;
+        QList<int> replacedBlocks;
+        int prevEnd = spanStart;
+        for (const auto& r : std::as_const(replacements)) {
+            const QStringView between = QStringView(spanText).mid(prevEnd - spanStart, r.start - prevEnd);
+            newText += between;
+            if (count < 1000)
+                replaced.append({spanStart + newText.size(), r.text.size()});
+            if (overview) {
+                separators += between.count(QChar(QChar::ParagraphSeparator));
+                if (replacedBlocks.isEmpty() || replacedBlocks.last() != firstBlock + separators)
+                    replacedBlocks.append(firstBlock + separators);
+                separators += r.text.count(QChar(QChar::ParagraphSeparator));
+            }
+            newText += r.text;
+            prevEnd = r.end;
+            ++count;
+        }
+        textEdit->replaceRange(spanStart, spanEnd, newText);
+        if (overview)
+            textEdit->vScrollBar()->setMarkers(VScrollBar::ReplaceMarker, replacedBlocks);
+        for (const auto& r : std::as_const(replaced)) {
+            tmp.setPosition(r.first);
+            tmp.setPosition(r.first + r.second, QTextCursor::KeepAnchor);
             extra.cursor = tmp;
             es.append(extra);
         }
-        start.setPosition(start.position());
-        ++count;
     }
     unbusy();
 
     textEdit->setGreenSel(es);
-    start.endEditBlock();
     if ((ui->actionLineNumbers->isChecked() || ui->spinBox->isVisible()))
         es.prepend(textEdit->currentLineSelection());
     es.append(textEdit->getBlueSel());
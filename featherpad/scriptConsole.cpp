@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) Pedram Pourang (aka Tsu Jan) 2026 <tsujan2000@gmail.com>
+ *
+ * FeatherPad is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FeatherPad is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @license GPL-3.0+ <https://spdx.org/licenses/GPL-3.0+.html>
+ */
+
+#include "scriptConsole.h"
+#include <QGridLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QScrollBar>
+#include <QTimerEvent>
+
+#define FLUSH_INTERVAL 50        // in ms
+#define SCROLLBACK_LINES 10000   // the maximum number of lines kept in the view
+#define MAX_PENDING 1048576      // the maximum number of characters waiting for a flush
+#define MAX_CARRY 4096           // longer escape sequences are considered broken
+
+namespace FeatherPad {
+
+/* Returns the position after the escape sequence that starts at "pos",
+   or -1 if the sequence is not complete yet. */
+static qsizetype escapeEnd(const QString& text, qsizetype pos) {
+    const qsizetype len = text.length();
+    if (pos + 1 >= len)
+        return -1;
+    const QChar c = text.at(pos + 1);
+    if (c == '[') {  // CSI
+        for (qsizetype i = pos + 2; i < len; ++i) {
+            const char16_t u = text.at(i).unicode();
+            if (u >= 0x40 && u <= 0x7e)
+                return i + 1;
+            if (u < 0x20 || u > 0x3f)
+                return i;  // malformed
+        }
+        return -1;
+    }
+    if (c == ']') {  // OSC, terminated by BEL or ST
+        for (qsizetype i = pos + 2; i < len; ++i) {
+            if (text.at(i) == '\a')
+                return i + 1;
+            if (text.at(i) == '\x1b') {
+                if (i + 1 >= len)
+                    return -1;
+                if (text.at(i + 1) == '\\')
+                    return i + 2;
+            }
+        }
+        return -1;
+    }
+    return pos + 2;
+}
+
+static QColor ansiColor(int index) {
+    static const QRgb basic[16] = {0x000000, 0xcd0000, 0x00cd00, 0xcdcd00, 0x0000ee, 0xcd00cd, 0x00cdcd, 0xe5e5e5,
+                                   0x7f7f7f, 0xff0000, 0x00ff00, 0xffff00, 0x5c5cff, 0xff00ff, 0x00ffff, 0xffffff};
+    index = qBound(0, index, 255);
+    if (index < 16)
+        return QColor(basic[index]);
+    if (index < 232) {  // the 6x6x6 color cube
+        index -= 16;
+        auto level = [](int v) { return v == 0 ? 0 : 55 + v * 40; };
+        return QColor(level(index / 36), level((index / 6) % 6), level(index % 6));
+    }
+    const int gray = 8 + (index - 232) * 10;
+    return QColor(gray, gray, gray);
+}
+/*************************/
+ScriptConsole::ScriptConsole(QProcess* process, const QString& fileName, QWidget* parent)
+    : QDialog(parent),
+      process_(process),
+      outDecoder_(QStringDecoder::Utf8),
+      errDecoder_(QStringDecoder::Utf8),
+      pendingSize_(0),
+      dropped_(false),
+      flushTimerId_(0) {
+    setWindowTitle(tr("Script Output"));
+    setSizeGripEnabled(true);
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    QGridLayout* grid = new QGridLayout;
+    QLabel* label = new QLabel(this);
+    label->setText("<center><b>" + tr("Script File") + ": </b></center><i>" + fileName + "</i>");
+    label->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    label->setWordWrap(true);
+    label->setMargin(5);
+    grid->addWidget(label, 0, 0, 1, 3);
+    tEdit_ = new QPlainTextEdit(this);
+    tEdit_->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    tEdit_->setUndoRedoEnabled(false);
+    tEdit_->setMaximumBlockCount(SCROLLBACK_LINES);
+    grid->addWidget(tEdit_, 1, 0, 1, 3);
+    QPushButton* clearButton = new QPushButton(QIcon::fromTheme("edit-clear"), tr("Clear"));
+    connect(clearButton, &QAbstractButton::clicked, this, &ScriptConsole::clear);
+    grid->addWidget(clearButton, 2, 0, Qt::AlignLeft);
+    ansiBox_ = new QCheckBox(tr("ANSI colors"));
+    ansiBox_->setToolTip(tr("Interpret the color codes of the output"));
+    ansiBox_->setChecked(true);
+    grid->addWidget(ansiBox_, 2, 1, Qt::AlignLeft);
+    QPushButton* closeButton = new QPushButton(QIcon::fromTheme("edit-delete"), tr("Close"));
+    connect(closeButton, &QAbstractButton::clicked, this, &QDialog::reject);
+    grid->addWidget(closeButton, 2, 2, Qt::AlignRight);
+    grid->setColumnStretch(1, 1);
+    setLayout(grid);
+
+    errBase_.setForeground(QColor(220, 50, 47));
+    outFormat_ = outBase_;
+    errFormat_ = errBase_;
+
+    if (process) {
+        connect(process, &QProcess::readyReadStandardOutput, this, &ScriptConsole::readOutput);
+        connect(process, &QProcess::readyReadStandardError, this, &ScriptConsole::readError);
+        connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, &ScriptConsole::flush);
+        /* the console may be created after the process has written something */
+        readOutput();
+        readError();
+    }
+}
+/*************************/
+void ScriptConsole::readOutput() {
+    read(QProcess::StandardOutput);
+}
+/*************************/
+void ScriptConsole::readError() {
+    read(QProcess::StandardError);
+}
+/*************************/
+void ScriptConsole::read(QProcess::ProcessChannel channel) {
+    if (process_ == nullptr)
+        return;
+    const bool isError = channel == QProcess::StandardError;
+    const QByteArray data = isError ? process_->readAllStandardError() : process_->readAllStandardOutput();
+    if (data.isEmpty())
+        return;
+
+    /* the decoders are stateful, so that multibyte characters may be split between chunks */
+    QString& carry = isError ? errCarry_ : outCarry_;
+    QString text = carry + (isError ? errDecoder_.decode(data) : outDecoder_.decode(data));
+    carry.clear();
+
+    /* keep an incomplete escape sequence for the next chunk */
+    const qsizetype esc = text.lastIndexOf(QLatin1Char('\x1b'));
+    if (esc > -1 && text.length() - esc < MAX_CARRY && escapeEnd(text, esc) == -1) {
+        carry = text.mid(esc);
+        text.truncate(esc);
+    }
+    if (text.isEmpty())
+        return;
+
+    if (!pending_.isEmpty() && pending_.last().isError == isError)
+        pending_.last().text += text;
+    else
+        pending_.append({text, isError});
+    pendingSize_ += text.length();
+
+    /* if the output is produced faster than it can be shown, drop the oldest part */
+    while (pendingSize_ > MAX_PENDING) {
+        dropped_ = true;
+        segment& first = pending_.first();
+        const qsizetype excess = pendingSize_ - MAX_PENDING;
+        if (first.text.length() <= excess) {
+            pendingSize_ -= first.text.length();
+            pending_.removeFirst();
+        }
+        else {
+            first.text.remove(0, excess);
+            pendingSize_ -= excess;
+        }
+    }
+
+    if (flushTimerId_ == 0)
+        flushTimerId_ = startTimer(FLUSH_INTERVAL);
+}
+/*************************/
+void ScriptConsole::timerEvent(QTimerEvent* event) {
+    if (event->timerId() == flushTimerId_)
+        flush();
+    else
+        QDialog::timerEvent(event);
+}
+/*************************/
+void ScriptConsole::flush() {
+    if (flushTimerId_) {
+        killTimer(flushTimerId_);
+        flushTimerId_ = 0;
+    }
+    if (pending_.isEmpty())
+        return;
+
+    QScrollBar* vbar = tEdit_->verticalScrollBar();
+    const bool atBottom = vbar->value() == vbar->maximum();
+
+    QTextCursor cursor(tEdit_->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.beginEditBlock();
+    if (dropped_) {
+        dropped_ = false;
+        QTextCharFormat fmt;
+        fmt.setFontItalic(true);
+        if (!cursor.atBlockStart())
+            cursor.insertBlock();
+        cursor.insertText("[...]", fmt);
+        cursor.insertBlock();
+    }
+    for (const auto& seg : std::as_const(pending_))
+        insertText(cursor, seg.text, seg.isError);
+    cursor.endEditBlock();
+    pending_.clear();
+    pendingSize_ = 0;
+
+    if (atBottom)
+        vbar->setValue(vbar->maximum());
+}
+/*************************/
+void ScriptConsole::insertText(QTextCursor& cursor, const QString& text, bool isError) {
+    QTextCharFormat& fmt = isError ? errFormat_ : outFormat_;
+    const QTextCharFormat& base = isError ? errBase_ : outBase_;
+    const bool ansi = ansiBox_->isChecked();
+    QString plain;
+    qsizetype i = 0;
+    const qsizetype len = text.length();
+    while (i < len) {
+        const QChar c = text.at(i);
+        if (c == '\x1b') {
+            qsizetype end = escapeEnd(text, i);
+            if (end == -1)
+                end = len;
+            if (ansi && end - i > 2 && text.at(i + 1) == '[' && text.at(end - 1) == 'm') {
+                if (!plain.isEmpty()) {
+                    cursor.insertText(plain, fmt);
+                    plain.clear();
+                }
+                applySgr(text.mid(i + 2, end - i - 3), fmt, base);
+            }
+            i = end;  // other escape sequences are just removed
+            continue;
+        }
+        if (c != '\r')
+            plain += c;
+        ++i;
+    }
+    if (!plain.isEmpty())
+        cursor.insertText(plain, ansi ? fmt : base);
+}
+/*************************/
+void ScriptConsole::applySgr(const QString& params, QTextCharFormat& fmt, const QTextCharFormat& base) const {
+    const QStringList parts = params.split(QLatin1Char(';'));
+    for (int i = 0; i < parts.size(); ++i) {
+        const int n = parts.at(i).toInt();  // an empty parameter means zero
+        if (n == 0)
+            fmt = base;
+        else if (n == 1)
+            fmt.setFontWeight(QFont::Bold);
+        else if (n == 22)
+            fmt.setFontWeight(QFont::Normal);
+        else if (n == 3)
+            fmt.setFontItalic(true);
+        else if (n == 23)
+            fmt.setFontItalic(false);
+        else if (n == 4)
+            fmt.setFontUnderline(true);
+        else if (n == 24)
+            fmt.setFontUnderline(false);
+        else if (n >= 30 && n <= 37)
+            fmt.setForeground(ansiColor(n - 30));
+        else if (n >= 90 && n <= 97)
+            fmt.setForeground(ansiColor(n - 90 + 8));
+        else if (n >= 40 && n <= 47)
+            fmt.setBackground(ansiColor(n - 40));
+        else if (n >= 100 && n <= 107)
+            fmt.setBackground(ansiColor(n - 100 + 8));
+        else if (n == 39) {
+            if (base.hasProperty(QTextFormat::ForegroundBrush))
+                fmt.setForeground(base.foreground());
+            else
+                fmt.clearForeground();
+        }
+        else if (n == 49)
+            fmt.clearBackground();
+        else if (n == 38 || n == 48) {  // 256 colors or true colors
+            QColor color;
+            if (i + 2 < parts.size() && parts.at(i + 1) == "5") {
+                color = ansiColor(parts.at(i + 2).toInt());
+                i += 2;
+            }
+            else if (i + 4 < parts.size() && parts.at(i + 1) == "2") {
+                color = QColor(qBound(0, parts.at(i + 2).toInt(), 255), qBound(0, parts.at(i + 3).toInt(), 255),
+                               qBound(0, parts.at(i + 4).toInt(), 255));
+                i += 4;
+            }
+            else
+                break;
+            if (n == 38)
+                fmt.setForeground(color);
+            else
+                fmt.setBackground(color);
+        }
+    }
+}
+/*************************/
+void ScriptConsole::clear() {
+    tEdit_->clear();
+    pending_.clear();
+    pendingSize_ = 0;
+    dropped_ = false;
+}
+
+}  // namespace FeatherPad
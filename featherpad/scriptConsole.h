@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) Pedram Pourang (aka Tsu Jan) 2026 <tsujan2000@gmail.com>
+ *
+ * FeatherPad is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FeatherPad is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @license GPL-3.0+ <https://spdx.org/licenses/GPL-3.0+.html>
+ */
+
+#ifndef SCRIPTCONSOLE_H
+#define SCRIPTCONSOLE_H
+
+#include <QDialog>
+#include <QPointer>
+#include <QProcess>
+#include <QPlainTextEdit>
+#include <QCheckBox>
+#include <QStringDecoder>
+#include <QTextCharFormat>
+
+namespace FeatherPad {
+
+/* A non-modal dialog that shows the output of a running script. The output is
+   read from the process directly, buffered and appended to the end of the view
+   at a limited rate; the view keeps a bounded number of lines. */
+class ScriptConsole : public QDialog {
+    Q_OBJECT
+
+   public:
+    ScriptConsole(QProcess* process, const QString& fileName, QWidget* parent = nullptr);
+
+   protected:
+    void timerEvent(QTimerEvent* event) override;
+
+   private slots:
+    void readOutput();
+    void readError();
+    void flush();
+    void clear();
+
+   private:
+    struct segment {
+        QString text;
+        bool isError;
+    };
+
+    void read(QProcess::ProcessChannel channel);
+    void insertText(QTextCursor& cursor, const QString& text, bool isError);
+    void applySgr(const QString& params, QTextCharFormat& fmt, const QTextCharFormat& base) const;
+
+    QPointer<QProcess> process_;
+    QPlainTextEdit* tEdit_;
+    QCheckBox* ansiBox_;
+    QStringDecoder outDecoder_;
+    QStringDecoder errDecoder_;
+    QString outCarry_;  // an incomplete escape sequence at the end of the last chunk
+    QString errCarry_;
+    QList<segment> pending_;
+    qsizetype pendingSize_;
+    bool dropped_;  // whether some pending text is dropped because of its size
+    QTextCharFormat outBase_;
+    QTextCharFormat errBase_;
+    QTextCharFormat outFormat_;  // the current ANSI format of each channel
+    QTextCharFormat errFormat_;
+    int flushTimerId_;
+};
+
+}  // namespace FeatherPad
+
+#endif  // SCRIPTCONSOLE_H
@@ -55,6 +55,7 @@ FPsingleton::FPsingleton(int& argc, char** argv) : QApplication(argc, argv) {
     standalone_ = false;
     quitSignalReceived_ = false;
     isRoot_ = false;
+    prefVersion_ = 0;
     config_.readConfig();
     lastFiles_ = config_.getLastFiles();
     if (config_.getSharedSearchHistory())
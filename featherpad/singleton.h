@@ -58,6 +58,11 @@ class FPsingleton : public QApplication {
 
     QStandardItemModel* searchModel() const { return searchModel_; }
 
+    /* The version of the per-tab preferences. It is increased when they are changed,
+       so that each tab can apply the changes lazily, when it becomes visible. */
+    int prefVersion() const { return prefVersion_; }
+    void outdatePrefs() { ++prefVersion_; }
+
    public slots:
     void quitSignalReceived();
     void quitting();
@@ -75,6 +80,7 @@ class FPsingleton : public QApplication {
     bool isWayland_;
     bool isRoot_;
     QStandardItemModel* searchModel_;  // The common search history if any.
+    int prefVersion_;
 };
 
 }  // namespace FeatherPad
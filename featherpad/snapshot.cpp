@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) Pedram Pourang (aka Tsu Jan) 2026 <tsujan2000@gmail.com>
+ *
+ * FeatherPad is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FeatherPad is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @license GPL-3.0+ <https://spdx.org/licenses/GPL-3.0+.html>
+ */
+
+#include "snapshot.h"
+#include <QTextDocument>
+#include <QTextBlock>
+
+#include <algorithm>
+
+#define CHUNK_BLOCKS 1024
+
+namespace FeatherPad {
+
+QString DocumentSnapshot::text() const {
+    qsizetype size = 0;
+    for (const auto& chunk : chunks_)
+        size += chunk.text.size();
+    QString txt;
+    txt.reserve(size);
+    for (const auto& chunk : chunks_)
+        txt += chunk.text;
+    txt.chop(1);  // the last newline
+    return txt;
+}
+/*************************/
+SnapshotTracker::SnapshotTracker(QTextDocument* doc, QObject* parent)
+    : QObject(parent), doc_(doc), revision_(0), docRevision_(doc->revision()) {
+    blockCount_ = doc_->blockCount();
+    chunks_ << DocumentSnapshot::Chunk{blockCount_, QString()};
+    connect(doc_, &QTextDocument::contentsChange, this, &SnapshotTracker::onContentsChange);
+}
+/*************************/
+// The changed blocks are found as in VScrollBar::onContentsChange(). Their
+// chunks are merged into a changed chunk, which is split when it's copied.
+void SnapshotTracker::onContentsChange(int position, int charsRemoved, int charsAdded) {
+    /* the highlighter changes formats with equal numbers of removed and added characters */
+    if (charsRemoved == charsAdded && doc_->revision() == docRevision_)
+        return;
+    docRevision_ = doc_->revision();
+    ++revision_;
+
+    const int count = doc_->blockCount();
+    const int diff = count - blockCount_;
+    blockCount_ = count;
+    QTextBlock block = doc_->findBlock(position);
+    QTextBlock lastBlock = doc_->findBlock(position + charsAdded);
+    if (!block.isValid()) {
+        chunks_ = {DocumentSnapshot::Chunk{count, QString()}};
+        return;
+    }
+    const int first = block.blockNumber();
+    const int oldLast = (lastBlock.isValid() ? lastBlock.blockNumber() : count - 1) - diff;
+
+    /* find the chunks of the changed blocks (with the old block numbers) */
+    int i = 0, start = 0;
+    while (i < chunks_.size() && start + chunks_.at(i).blocks <= first) {
+        start += chunks_.at(i).blocks;
+        ++i;
+    }
+    if (i == chunks_.size()) {  // a precaution
+        chunks_ = {DocumentSnapshot::Chunk{count, QString()}};
+        return;
+    }
+    int j = i;
+    int blocks = chunks_.at(i).blocks;
+    while (start + blocks <= oldLast && j + 1 < chunks_.size()) {
+        ++j;
+        blocks += chunks_.at(j).blocks;
+    }
+    blocks += diff;
+    if (blocks <= 0) {  // a precaution
+        chunks_ = {DocumentSnapshot::Chunk{count, QString()}};
+        return;
+    }
+    chunks_.remove(i + 1, j - i);
+    chunks_[i] = DocumentSnapshot::Chunk{blocks, QString()};
+}
+/*************************/
+DocumentSnapshot SnapshotTracker::snapshot() {
+    if (last_.revision_ == revision_)
+        return last_;
+
+    QList<DocumentSnapshot::Chunk> chunks;
+    chunks.reserve(chunks_.size());
+    int start = 0;
+    for (const auto& chunk : std::as_const(chunks_)) {
+        if (!chunk.text.isNull()) {
+            chunks << chunk;
+            start += chunk.blocks;
+            continue;
+        }
+        /* copy the changed blocks */
+        QTextBlock block = doc_->findBlockByNumber(start);
+        int remaining = chunk.blocks;
+        while (remaining > 0 && block.isValid()) {
+            DocumentSnapshot::Chunk c{std::min(remaining, CHUNK_BLOCKS), QString()};
+            for (int k = 0; k < c.blocks && block.isValid(); ++k, block = block.next()) {
+                c.text += block.text();
+                c.text += QLatin1Char('\n');
+            }
+            /* as in QTextDocument::toPlainText() */
+            for (QChar& ch : c.text) {
+                switch (ch.unicode()) {
+                    case 0xfdd0:
+                    case 0xfdd1:
+                    case QChar::ParagraphSeparator:
+                    case QChar::LineSeparator:
+                        ch = QLatin1Char('\n');
+                        break;
+                    case QChar::Nbsp:
+                        ch = QLatin1Char(' ');
+                        break;
+                    default:
+                        break;
+                }
+            }
+            chunks << c;
+            remaining -= c.blocks;
+        }
+        start += chunk.blocks;
+    }
+    chunks_ = chunks;
+
+    last_.chunks_ = chunks_;
+    last_.revision_ = revision_;
+    last_.blockCount_ = blockCount_;
+    return last_;
+}
+
+}  // namespace FeatherPad
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) Pedram Pourang (aka Tsu Jan) 2026 <tsujan2000@gmail.com>
+ *
+ * FeatherPad is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FeatherPad is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @license GPL-3.0+ <https://spdx.org/licenses/GPL-3.0+.html>
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+
+class QTextDocument;
+
+namespace FeatherPad {
+
+/* An immutable copy of the text of a document, which can be read in other
+   threads. The text is kept in chunks of blocks. A new snapshot shares the
+   unchanged chunks with the previous one (they're implicitly shared), so it
+   is cheap to make after small edits. The revision shows which state of the
+   document a snapshot has; the results of threads can be tagged with it. */
+class DocumentSnapshot {
+   public:
+    bool isNull() const { return revision_ < 0; }
+    int revision() const { return revision_; }
+    int blockCount() const { return blockCount_; }
+
+    /* Joins the chunks. The text is like that of QTextDocument::toPlainText(). */
+    QString text() const;
+
+   private:
+    friend class SnapshotTracker;
+    struct Chunk {
+        int blocks;
+        QString text;  // each block with a newline (null if the blocks are changed)
+    };
+
+    QList<Chunk> chunks_;
+    int revision_ = -1;
+    int blockCount_ = 0;
+};
+
+/* Follows the changes of a document to know which chunks should be
+   copied again for the next snapshot. */
+class SnapshotTracker : public QObject {
+    Q_OBJECT
+
+   public:
+    SnapshotTracker(QTextDocument* doc, QObject* parent = nullptr);
+
+    DocumentSnapshot snapshot();
+    int revision() const { return revision_; }
+
+   private slots:
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
+
+   private:
+    QTextDocument* doc_;
+    QList<DocumentSnapshot::Chunk> chunks_;  // the blocks of the current text
+    int blockCount_;
+    int revision_;
+    int docRevision_;  // for telling text changes from format changes
+    DocumentSnapshot last_;
+};
+
+}  // namespace FeatherPad
+
+#endif  // SNAPSHOT_H
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) Pedram Pourang (aka Tsu Jan) 2026 <tsujan2000@gmail.com>
+ *
+ * FeatherPad is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FeatherPad is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @license GPL-3.0+ <https://spdx.org/licenses/GPL-3.0+.html>
+ */
+
+#include "statusinfo.h"
+#include <QHBoxLayout>
+
+namespace FeatherPad {
+
+StatusSegment::StatusSegment(const QString& title, QWidget* parent) : QWidget(parent) {
+    title_ = new QLabel(title, this);
+    title_->setTextFormat(Qt::PlainText);
+    QFont f = title_->font();
+    f.setBold(true);
+    title_->setFont(f);
+
+    value_ = new QLabel(this);
+    value_->setTextFormat(Qt::PlainText);
+    value_->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    f = value_->font();
+    f.setItalic(true);
+    value_->setFont(f);
+
+    QHBoxLayout* layout = new QHBoxLayout;
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(fontMetrics().horizontalAdvance(' '));
+    layout->addWidget(title_);
+    layout->addWidget(value_);
+    setLayout(layout);
+}
+/*************************/
+void StatusSegment::setValue(const QString& value) {
+    if (value != value_->text())
+        value_->setText(value);
+}
+/*************************/
+StatusInfo::StatusInfo(QWidget* parent)
+    : QWidget(parent), lineCount_(-1), selectionSize_(-1), selLineCount_(-1), selWordCount_(-2), wordCount_(-2) {
+    encoding_ = new StatusSegment(tr("Encoding:"), this);
+    syntax_ = new StatusSegment(tr("Syntax:"), this);
+    syntax_->hide();
+    lines_ = new StatusSegment(tr("Lines:"), this);
+    selection_ = new StatusSegment(tr("Sel. Chars:"), this);
+    selLines_ = new StatusSegment(tr("Sel. Lines:"), this);
+    selLines_->hide();
+    selWords_ = new StatusSegment(tr("Sel. Words:"), this);
+    selWords_->hide();
+    words_ = new StatusSegment(tr("Words:"), this);
+
+    QHBoxLayout* layout = new QHBoxLayout;
+    layout->setContentsMargins(2, 0, 0, 0);
+    layout->setSpacing(3 * fontMetrics().horizontalAdvance(' '));
+    layout->addWidget(encoding_);
+    layout->addWidget(syntax_);
+    layout->addWidget(lines_);
+    layout->addWidget(selection_);
+    layout->addWidget(selLines_);
+    layout->addWidget(selWords_);
+    layout->addWidget(words_);
+    setLayout(layout);
+}
+/*************************/
+void StatusInfo::setEncoding(const QString& encoding) {
+    encoding_->setValue(encoding);
+}
+/*************************/
+void StatusInfo::setSyntax(const QString& syntax) {
+    syntax_->setValue(syntax);
+    syntax_->setVisible(!syntax.isEmpty());
+}
+/*************************/
+void StatusInfo::setLines(int lines) {
+    if (lines == lineCount_)
+        return;
+    lineCount_ = lines;
+    lines_->setValue(locale().toString(lines));
+}
+/*************************/
+void StatusInfo::setSelection(int chars, int lines, int words) {
+    if (chars != selectionSize_) {
+        selectionSize_ = chars;
+        selection_->setValue(locale().toString(chars));
+    }
+    if (lines != selLineCount_) {
+        selLineCount_ = lines;
+        selLines_->setValue(locale().toString(lines));
+    }
+    if (words != selWordCount_) {
+        selWordCount_ = words;
+        selWords_->setValue(words < 0 ? QString() : locale().toString(words));
+    }
+    selLines_->setVisible(chars > 0);
+    selWords_->setVisible(chars > 0);
+}
+/*************************/
+void StatusInfo::setWords(int words) {
+    if (words == wordCount_)
+        return;
+    wordCount_ = words;
+    words_->setValue(words < 0 ? QString() : locale().toString(words));
+}
+
+}  // namespace FeatherPad
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) Pedram Pourang (aka Tsu Jan) 2026 <tsujan2000@gmail.com>
+ *
+ * FeatherPad is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FeatherPad is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @license GPL-3.0+ <https://spdx.org/licenses/GPL-3.0+.html>
+ */
+
+#ifndef STATUSINFO_H
+#define STATUSINFO_H
+
+#include <QLabel>
+
+namespace FeatherPad {
+
+/* A plain-text item of the status bar, with a bold title and an italic value.
+   Only the value is changed later, without any rich-text parsing. */
+class StatusSegment : public QWidget {
+    Q_OBJECT
+
+   public:
+    StatusSegment(const QString& title, QWidget* parent = nullptr);
+
+    void setValue(const QString& value);
+
+   private:
+    QLabel* title_;
+    QLabel* value_;
+};
+
+/* The document info of the status bar, in this order:
+   Encoding -> Syntax -> Lines -> Sel. Chars -> Sel. Lines -> Sel. Words -> Words
+   (the selected lines and words are shown only with a selection) */
+class StatusInfo : public QWidget {
+    Q_OBJECT
+
+   public:
+    StatusInfo(QWidget* parent = nullptr);
+
+    void setEncoding(const QString& encoding);
+    void setSyntax(const QString& syntax);  // an empty syntax is hidden
+    void setLines(int lines);
+    void setSelection(int chars, int lines = 0, int words = -1);  // words = -1 means unknown
+    void setWords(int words);  // -1 means unknown
+
+   private:
+    StatusSegment* encoding_;
+    StatusSegment* syntax_;
+    StatusSegment* lines_;
+    StatusSegment* selection_;
+    StatusSegment* selLines_;
+    StatusSegment* selWords_;
+    StatusSegment* words_;
+    /* the last numbers, for not formatting them again */
+    int lineCount_;
+    int selectionSize_;
+    int selLineCount_;
+    int selWordCount_;
+    int wordCount_;
+};
+
+}  // namespace FeatherPad
+
+#endif  // STATUSINFO_H
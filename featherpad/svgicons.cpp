@@ -29,7 +29,7 @@
 #include <QIconEngine>
 #include <QSvgRenderer>
 #include <QPainter>
-#include <QPixmapCache>
+#include <QHash>
 #include <QRect>
 #include <QFontDatabase>
 #include <QApplication>
@@ -39,13 +39,84 @@
 
 namespace FeatherPad {
 
+/* Keeps the SVG data of symbolic icons and their rendered pixmaps, so that
+   painting an icon touches neither the disk nor the SVG parser after its first
+   rendering. Unlike with QPixmapCache, the pixmaps aren't evicted; they are
+   cleared when the application palette changes. */
+class symbolicIconCache {
+   public:
+    static symbolicIconCache& instance() {
+        /* not destroyed on exiting because pixmaps shouldn't outlive the application */
+        static symbolicIconCache* cache = new symbolicIconCache;
+        return *cache;
+    }
+
+    /* Reads an SVG file only once and returns its index (-1 for an empty file name). */
+    int fileIndex(const QString& fileName) {
+        if (fileName.isEmpty())
+            return -1;
+        auto it = indices_.constFind(fileName);
+        if (it != indices_.constEnd())
+            return it.value();
+        QByteArray bytes;
+        QFile f(fileName);
+        if (f.open(QIODevice::ReadOnly))
+            bytes = f.readAll();
+        svgData_.append(bytes);
+        const int index = svgData_.size() - 1;
+        indices_.insert(fileName, index);
+        return index;
+    }
+
+    QPixmap pixmap(int index, const QSize& size, const QColor& col) {
+        const qint64 paletteKey = QApplication::palette().cacheKey();
+        if (paletteKey != paletteKey_) {
+            paletteKey_ = paletteKey;
+            pixmaps_.clear();
+        }
+
+        /* the key has 16 bits for the index, 12 bits for each dimension and 24 bits for the color */
+        const bool cacheable = index >= 0 && index < 0x10000 && size.width() < 0x1000 && size.height() < 0x1000;
+        quint64 key = 0;
+        if (cacheable) {
+            key = (static_cast<quint64>(index) << 48) | (static_cast<quint64>(size.width()) << 36) |
+                  (static_cast<quint64>(size.height()) << 24) | (col.rgb() & 0xffffff);
+            auto it = pixmaps_.constFind(key);
+            if (it != pixmaps_.constEnd())
+                return it.value();
+        }
+
+        QPixmap pix(size);
+        pix.fill(Qt::transparent);
+        if (index >= 0 && index < svgData_.size() && !svgData_.at(index).isEmpty()) {
+            QByteArray bytes = svgData_.at(index);
+            bytes.replace("#000", col.name().toLatin1());
+            QSvgRenderer renderer(bytes);
+            QPainter p(&pix);
+            renderer.render(&p, QRect(QPoint(0, 0), size));
+        }
+        if (cacheable)
+            pixmaps_.insert(key, pix);
+        return pix;
+    }
+
+   private:
+    symbolicIconCache() : paletteKey_(0) {}
+
+    QList<QByteArray> svgData_;
+    QHash<QString, int> indices_;
+    QHash<quint64, QPixmap> pixmaps_;
+    qint64 paletteKey_;
+};
+
 class symbolicIconEngine : public QIconEngine {
    public:
-    symbolicIconEngine(const QString& file) : fileName(file) {}
+    symbolicIconEngine(const QString& file) : index(symbolicIconCache::instance().fileIndex(file)) {}
+    symbolicIconEngine(int fileIndex) : index(fileIndex) {}
 
     ~symbolicIconEngine() override {}
 
-    symbolicIconEngine* clone() const override { return new symbolicIconEngine(fileName); }
+    symbolicIconEngine* clone() const override { return new symbolicIconEngine(index); }
 
     void paint(QPainter* painter, const QRect& rect, QIcon::Mode mode, QIcon::State state) override {
         Q_UNUSED(state)
@@ -67,27 +138,7 @@ class symbolicIconEngine : public QIconEngine {
             col = QApplication::palette().highlightedText().color();
         else
             col = QApplication::palette().windowText().color();
-        QString key =
-            fileName + "-" + QString::number(rect.width()) + "-" + QString::number(rect.height()) + "-" + col.name();
-        QPixmap pix;
-        if (!QPixmapCache::find(key, &pix)) {
-            pix = QPixmap(rect.width(), rect.height());
-            pix.fill(Qt::transparent);
-            if (!fileName.isEmpty()) {
-                QSvgRenderer renderer;
-                QFile f(fileName);
-                QByteArray bytes;
-                if (f.open(QIODevice::ReadOnly))
-                    bytes = f.readAll();
-                if (!bytes.isEmpty())
-                    bytes.replace("#000", col.name().toLatin1());
-                renderer.load(bytes);
-                QPainter p(&pix);
-                renderer.render(&p, QRect(0, 0, rect.width(), rect.height()));
-            }
-            QPixmapCache::insert(key, pix);
-        }
-        painter->drawPixmap(rect.topLeft(), pix);
+        painter->drawPixmap(rect.topLeft(), symbolicIconCache::instance().pixmap(index, rect.size(), col));
     }
 
     QPixmap pixmap(const QSize& size, QIcon::Mode mode, QIcon::State state) override {
@@ -99,7 +150,7 @@ class symbolicIconEngine : public QIconEngine {
     }
 
    private:
-    QString fileName;
+    int index;
 };
 
 QIcon symbolicIcon::icon(const QString& fileName) {
@@ -373,7 +373,7 @@ void FPwin::syntaxHighlighting(TextEdit* textEdit, bool highlight, const QString
             return;
         }
 
-        Config config = static_cast<FPsingleton*>(qApp)->getConfig();
+        const Config& config = static_cast<FPsingleton*>(qApp)->getConfig();
         const qint64 textSize = textEdit->getSize();
         const qint64 maxSize = config.getMaxSHSize() * 1024LL * 1024LL;
         if (textSize > maxSize) {
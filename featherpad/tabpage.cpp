@@ -22,7 +22,11 @@
 
 namespace FeatherPad {
 
-TabPage::TabPage(int bgColorValue, const QList<QKeySequence>& searchShortcuts, QWidget* parent) : QWidget(parent) {
+TabPage::TabPage(int bgColorValue, const QList<QKeySequence>& searchShortcuts, QWidget* parent)
+    : QWidget(parent),
+      prefVersion_(0),
+      fileState_(FileUnknown),
+      executable_(false) {
     textEdit_ = new TextEdit(this, bgColorValue);
     searchBar_ = new SearchBar(this, searchShortcuts);
 
@@ -33,6 +37,32 @@ TabPage::TabPage(int bgColorValue, const QList<QKeySequence>& searchShortcuts, Q
     mainGrid->addWidget(searchBar_, 1, 0);
     setLayout(mainGrid);
 
+    /* the cached bytes aren't needed after the text is edited (see rawBytes()) */
+    connect(textEdit_->document(), &QTextDocument::modificationChanged, this, [this](bool modified) {
+        if (modified && !rawBytes_.isEmpty())
+            setRawBytes(QByteArray(), QDateTime());
+    });
+
+    /* keep the UI state up to date (see uiState()) */
+    QTextDocument* doc = textEdit_->document();
+    uiState_.undo = doc->isUndoAvailable();
+    uiState_.redo = doc->isRedoAvailable();
+    uiState_.modified = doc->isModified();
+    uiState_.canCopy = uiState_.textSelected = false;
+    uiState_.selChars = -1;
+    uiState_.selLines = 0;
+    uiState_.selWords = -1;
+    connect(doc, &QTextDocument::undoAvailable, this, [this](bool available) { uiState_.undo = available; });
+    connect(doc, &QTextDocument::redoAvailable, this, [this](bool available) { uiState_.redo = available; });
+    connect(doc, &QTextDocument::modificationChanged, this, [this](bool modified) { uiState_.modified = modified; });
+    connect(textEdit_, &TextEdit::canCopy, this, [this](bool yes) { uiState_.canCopy = yes; });
+    connect(textEdit_, &QPlainTextEdit::copyAvailable, this, [this](bool yes) { uiState_.textSelected = yes; });
+    connect(textEdit_, &QPlainTextEdit::selectionChanged, this, [this] { uiState_.selChars = -1; });
+    connect(doc, &QTextDocument::contentsChanged, this, [this] {
+        if (uiState_.selChars != 0)  // the selected text may have changed
+            uiState_.selChars = -1;
+    });
+
     connect(searchBar_, &SearchBar::find, this, &TabPage::find);
     connect(searchBar_, &SearchBar::searchFlagChanged, this, &TabPage::searchFlagChanged);
 }
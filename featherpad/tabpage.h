@@ -21,6 +21,8 @@
 #define TABPAGE_H
 
 #include <QPointer>
+#include <QDateTime>
+#include <QAction>
 #include "searchbar.h"
 #include "textedit.h"
 
@@ -29,6 +31,9 @@ namespace FeatherPad {
 class TabPage : public QWidget {
     Q_OBJECT
    public:
+    /* the state of the file on disk when it was last checked */
+    enum FileState { FileUnknown, FileUnchanged, FileChanged, FileMissing };
+
     TabPage(int bgColorValue = 255,
             const QList<QKeySequence>& searchShortcuts = QList<QKeySequence>(),
             QWidget* parent = nullptr);
@@ -53,6 +58,64 @@ class TabPage : public QWidget {
 
     void lockPage(bool lock);
 
+    /* the version of the preferences that are applied to this page */
+    int prefVersion() const { return prefVersion_; }
+    void setPrefVersion(int version) { prefVersion_ = version; }
+
+    /* These are cached by the window's file watcher, so that
+       switching to this page doesn't need to access the disk. */
+    FileState fileState() const { return fileState_; }
+    void setFileState(FileState state) { fileState_ = state; }
+    bool isExecutable() const { return executable_; }
+    void setExecutable(bool executable) { executable_ = executable; }
+
+    /* The compressed bytes of the file as they were loaded, with the modification
+       time of the file at that moment. They are used for switching the encoding
+       without reading the file again, and are kept only if the encoding was
+       detected and the text isn't modified. */
+    const QByteArray& rawBytes() const { return rawBytes_; }
+    const QDateTime& rawBytesTime() const { return rawBytesTime_; }
+    void setRawBytes(const QByteArray& rawBytes, const QDateTime& time) {
+        rawBytes_ = rawBytes;
+        rawBytesTime_ = time;
+    }
+
+    /* The states of the window's actions and statusbar for this page. The states
+       of the actions follow the signals of the text edit, and the other values are
+       cached when they are computed and dropped when they may change. So, switching
+       to this page only applies them. */
+    struct UiState {
+        bool undo;
+        bool redo;
+        bool modified;
+        bool canCopy;       // with a selection or a column selection
+        bool textSelected;  // with a selection
+        /* the shown name of the file "fileName" */
+        QString fileName;
+        QString shownName;
+        /* the action of "encoding" in the encoding menu of a window */
+        QString encoding;
+        QPointer<QAction> encodingAction;
+        /* the numbers of the selection (-1 characters if unknown) */
+        int selChars;
+        int selLines;
+        int selWords;
+    };
+    const UiState& uiState() const { return uiState_; }
+    void setShownName(const QString& fileName, const QString& shownName) {
+        uiState_.fileName = fileName;
+        uiState_.shownName = shownName;
+    }
+    void setEncodingAction(const QString& encoding, QAction* action) {
+        uiState_.encoding = encoding;
+        uiState_.encodingAction = action;
+    }
+    void setSelectionInfo(int chars, int lines, int words) {
+        uiState_.selChars = chars;
+        uiState_.selLines = lines;
+        uiState_.selWords = words;
+    }
+
    signals:
     void find(bool forward);
     void searchFlagChanged();
@@ -60,6 +123,12 @@ class TabPage : public QWidget {
    private:
     QPointer<TextEdit> textEdit_;
     QPointer<SearchBar> searchBar_;
+    int prefVersion_;
+    FileState fileState_;
+    bool executable_;
+    QByteArray rawBytes_;
+    QDateTime rawBytesTime_;
+    UiState uiState_;
 };
 
 }  // namespace FeatherPad
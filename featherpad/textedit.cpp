@@ -29,7 +29,9 @@
 #include <QClipboard>
 #include <QTextDocumentFragment>
 #include "textedit.h"
+#include "textlayout.h"
 #include "vscrollbar.h"
+#include "matchIndexer.h"
 
 #include <algorithm>
 #include <cmath>
@@ -37,6 +39,13 @@
 #define UPDATE_INTERVAL 50  // in ms
 #define SCROLL_FRAMES_PER_SEC 60
 #define SCROLL_DURATION 300  // in ms
+#define MATCH_INDEX_INTERVAL 500  // in ms
+#define MAX_REINDEXED_BLOCKS 2000  // more edited blocks are re-indexed in a thread
+#define FRAME_INTERVAL 16  // in ms
+#define MAX_WORD_COUNTED_SELECTION 1000000  // in characters
+#define PASTE_CHUNK_SIZE 1048576  // in characters; larger texts are pasted in chunks
+#define MIN_LAZY_SELECTION 100000  // in characters; smaller selections are copied at once
+#define ZOOM_DELAY 150  // in ms
 
 namespace FeatherPad {
 
@@ -64,8 +73,28 @@ TextEdit::TextEdit(QWidget* parent, int bgColorValue) : QPlainTextEdit(parent) {
 
     textTab_ = "    ";  // the default text tab is four spaces
 
+    undoMemoryLimit_ = 0;
+    undoSize_ = 0;
+    undoRevision_ = 0;
+    undoReplaying_ = false;
+    replayedSize_ = 0;
+
     resizeTimerId_ = 0;
     selectionTimerId_ = 0;
+    matchIndexTimerId_ = 0;
+    scheduledUpdates_ = 0;
+    updateTimerId_ = 0;
+    pastePos_ = 0;
+    pasteTimerId_ = 0;
+    pendingZoom_ = -1;
+    zoomTimerId_ = 0;
+    snapshotTracker_ = nullptr;
+    matchIndexRunning_ = matchIndexOutdated_ = false;
+    editedFirst_ = editedLast_ = -1;
+    markerBlockCount_ = markerRevision_ = 0;
+    searchMarkerRegex_ = false;
+    lastCursorBlock_ = 0;
+    foldRevision_ = foldBlockCount_ = 0;
     selectionHighlighting_ = false;
     highlightThisSelection_ = true;
     removeSelectionHighlights_ = false;
@@ -74,6 +103,11 @@ TextEdit::TextEdit(QWidget* parent, int bgColorValue) : QPlainTextEdit(parent) {
     encoding_ = "UTF-8";
     uneditable_ = false;
 
+    /* a document with a layout that can find its width without shaping all lines */
+    QTextDocument* doc = new QTextDocument(this);
+    doc->setDocumentLayout(new TextLayout(doc));
+    setDocument(doc);
+
     setMouseTracking(true);
     // document()->setUseDesignMetrics (true);
 
@@ -139,8 +173,9 @@ TextEdit::TextEdit(QWidget* parent, int bgColorValue) : QPlainTextEdit(parent) {
     setFrameShape(QFrame::NoFrame);
     /* first we replace the widget's vertical scrollbar with ours because
        we want faster wheel scrolling when the mouse cursor is on the scrollbar */
-    VScrollBar* vScrollBar = new VScrollBar;
-    setVerticalScrollBar(vScrollBar);
+    vScrollBar_ = new VScrollBar;
+    setVerticalScrollBar(vScrollBar_);
+    vScrollBar_->setDocument(document());
 
     lineNumberArea_ = new LineNumberArea(this);
     lineNumberArea_->setToolTip(tr("Double click to center current line"));
@@ -151,12 +186,19 @@ TextEdit::TextEdit(QWidget* parent, int bgColorValue) : QPlainTextEdit(parent) {
     connect(this, &QPlainTextEdit::cursorPositionChanged, [this] {
         if (!keepTxtCurHPos_)
             txtCurHPos_ = -1;  // forget the last cursor position if it shouldn't be remembered
-        emit updateBracketMatching();
+        scheduleUpdates(CursorUpdate | BracketUpdate);
         /* also, remove the column highlight if no mouse button is pressed */
         if (!colSel_.isEmpty() && !mousePressed_)
             removeColumnHighlight();
     });
     connect(this, &QPlainTextEdit::selectionChanged, this, &TextEdit::onSelectionChanged);
+    undoRevision_ = document()->revision();
+    connect(document(), &QTextDocument::contentsChange, this, &TextEdit::onUndoContentsChange);
+    connect(document(), &QTextDocument::undoAvailable, this, [this](bool available) {
+        if (!available && !document()->isRedoAvailable()) {  // the undo/redo stacks are cleared
+            undoSize_ = 0;
+        }
+    });
     connect(this, &QPlainTextEdit::copyAvailable, [this](bool yes) {
         if (yes)
             emit canCopy(true);
@@ -189,13 +231,31 @@ bool TextEdit::eventFilter(QObject* watched, QEvent* event) {
                 return false;
             }
         }
-        else if (event->type() == QEvent::MouseButtonPress)
+        else if (event->type() == QEvent::MouseButtonPress) {
+            /* fold or unfold by clicking the fold marker */
+            QMouseEvent* me = static_cast<QMouseEvent*>(event);
+            const int fw = foldMarginWidth();
+            if (fw > 0 && me->button() == Qt::LeftButton) {
+                const QPoint p = me->position().toPoint();
+                if (QApplication::layoutDirection() == Qt::RightToLeft ? p.x() < fw
+                                                                       : p.x() >= lineNumberArea_->width() - fw) {
+                    const QTextBlock block = cursorForPosition(QPoint(0, p.y())).block();
+                    if (isFolded(block) || isFoldHeader(block))
+                        toggleFold(block);
+                }
+            }
             return true;  // prevent the window from being dragged by widget styles (like Kvantum)
+        }
     }
     return QPlainTextEdit::eventFilter(watched, event);
 }
 /*************************/
 void TextEdit::setEditorFont(const QFont& f, bool setDefault) {
+    if (zoomTimerId_) {  // a pending zoom is canceled
+        killTimer(zoomTimerId_);
+        zoomTimerId_ = 0;
+        pendingZoom_ = -1;
+    }
     if (setDefault)
         font_ = f;
     setFont(f);
@@ -206,6 +266,8 @@ void TextEdit::setEditorFont(const QFont& f, bool setDefault) {
     QTextOption opt = document()->defaultTextOption();
     opt.setTabStopDistance(metrics.horizontalAdvance(textTab_));
     document()->setDefaultTextOption(opt);
+    if (auto layout = qobject_cast<TextLayout*>(document()->documentLayout()))
+        layout->setCharWidth(QFontInfo(f).fixedPitch() ? metrics.horizontalAdvance(QLatin1Char(' ')) : 0);
 
     /* the line number is bold only for the current line */
     QFont F(f);
@@ -228,7 +290,10 @@ void TextEdit::setEditorFont(const QFont& f, bool setDefault) {
     }
 }
 /*************************/
+static void detachSelectionData(const QTextDocument* doc);
 TextEdit::~TextEdit() {
+    /* the document may outlive this text edit (see FPwin::deleteTabPage) */
+    detachSelectionData(document());
     if (scrollTimer_) {
         disconnect(scrollTimer_, &QTimer::timeout, this, &TextEdit::scrollWithInertia);
         scrollTimer_->stop();
@@ -242,7 +307,6 @@ void TextEdit::showLineNumbers(bool show) {
         lineNumberArea_->show();
         connect(this, &QPlainTextEdit::blockCountChanged, this, &TextEdit::updateLineNumberAreaWidth);
         connect(this, &QPlainTextEdit::updateRequest, this, &TextEdit::updateLineNumberArea);
-        connect(this, &QPlainTextEdit::cursorPositionChanged, this, &TextEdit::highlightCurrentLine);
 
         updateLineNumberAreaWidth(0);
         highlightCurrentLine();
@@ -250,7 +314,6 @@ void TextEdit::showLineNumbers(bool show) {
     else {
         disconnect(this, &QPlainTextEdit::blockCountChanged, this, &TextEdit::updateLineNumberAreaWidth);
         disconnect(this, &QPlainTextEdit::updateRequest, this, &TextEdit::updateLineNumberArea);
-        disconnect(this, &QPlainTextEdit::cursorPositionChanged, this, &TextEdit::highlightCurrentLine);
 
         lineNumberArea_->hide();
         setViewportMargins(0, 0, 0, 0);
@@ -273,7 +336,8 @@ int TextEdit::lineNumberAreaWidth() {
     }
     QFont f = font();
     f.setBold(true);
-    return (6 + QFontMetrics(f).horizontalAdvance(num));  // 6 = 3 + 3 (-> lineNumberAreaPaintEvent)
+    return (6 + QFontMetrics(f).horizontalAdvance(num)  // 6 = 3 + 3 (-> lineNumberAreaPaintEvent)
+            + foldMarginWidth());
 }
 /*************************/
 void TextEdit::updateLineNumberAreaWidth(int /* newBlockCount */) {
@@ -445,6 +509,10 @@ static inline bool isOnlySpaces(const QString& str) {
 
 void TextEdit::keyPressEvent(QKeyEvent* event) {
     keepTxtCurHPos_ = false;
+    if (!isReadOnly() &&
+        (!event->text().isEmpty() || event->key() == Qt::Key_Backspace || event->key() == Qt::Key_Delete)) {
+        keepSelectionData();  // the key may change the text
+    }
 
     /* first, deal with spacial cases of pressing Ctrl */
     if (event->modifiers() & Qt::ControlModifier) {
@@ -528,7 +596,7 @@ void TextEdit::keyPressEvent(QKeyEvent* event) {
         bool hadSelection(textCursor().hasSelection());
         QPlainTextEdit::keyPressEvent(event);
         if (!hadSelection)
-            emit updateBracketMatching();  // isn't emitted in another way
+            scheduleUpdates(BracketUpdate);  // isn't scheduled in another way
         return;
     }
 
@@ -1207,21 +1275,105 @@ void TextEdit::keyPressEvent(QKeyEvent* event) {
     QPlainTextEdit::keyPressEvent(event);
 }
 /*************************/
+// The selected text as "QTextDocumentFragment::toPlainText()" would give it
+// but without creating a fragment, i.e., without copying the text twice.
+static QString plainSelection(const QTextCursor& cursor) {
+    QString txt = cursor.selectedText();
+    for (QChar& c : txt) {
+        switch (c.unicode()) {
+            case 0xfdd0:
+            case 0xfdd1:
+            case QChar::ParagraphSeparator:
+            case QChar::LineSeparator:
+                c = QLatin1Char('\n');
+                break;
+            case QChar::Nbsp:
+                c = QLatin1Char(' ');
+                break;
+            default:
+                break;
+        }
+    }
+    return txt;
+}
+
+// The MIME data of the selection clipboard, which is updated whenever the
+// selection is changed by the mouse. With a large selection, it only keeps a
+// cursor, and the text is produced when another app asks for it or before the
+// document is edited (see TextEdit::keepSelectionData()). If the document is
+// edited in a way that doesn't produce the text first, nothing is given, rather
+// than a text that isn't the selected one.
+class SelectionMimeData : public QMimeData {
+   public:
+    SelectionMimeData(const QTextCursor& cursor) : cursor_(cursor), revision_(cursor.document()->revision()) {
+        last_ = this;
+    }
+    SelectionMimeData(const QString& text) : text_(text), revision_(-1) { last_ = this; }
+    ~SelectionMimeData() override {
+        if (last_ == this)
+            last_ = nullptr;
+    }
+
+    bool hasFormat(const QString& mimeType) const override { return mimeType == QLatin1String("text/plain"); }
+    QStringList formats() const override { return {QStringLiteral("text/plain")}; }
+
+    /* Before the document is edited or its text edit is deleted, the text is
+       produced and the cursor is released, so that the selection can be pasted later. */
+    static void detach(const QTextDocument* doc) {
+        if (last_ && !last_->cursor_.isNull() && last_->cursor_.document() == doc) {
+            if (doc->revision() == last_->revision_)
+                last_->text_ = plainSelection(last_->cursor_);
+            last_->cursor_ = QTextCursor();
+        }
+    }
+
+   protected:
+    QVariant retrieveData(const QString& mimeType, QMetaType /*type*/) const override {
+        if (mimeType != QLatin1String("text/plain"))
+            return QVariant();
+        if (cursor_.isNull()) {  // detached or the document is deleted
+            if (text_.isEmpty())
+                return QVariant();
+            return text_;
+        }
+        if (cursor_.document()->revision() != revision_)
+            return QVariant();  // the text is edited
+        return plainSelection(cursor_);
+    }
+
+   private:
+    QTextCursor cursor_;
+    QString text_;
+    int revision_;  // the revision of the document when the text was selected
+    static SelectionMimeData* last_;  // only the last one may be in the clipboard
+};
+SelectionMimeData* SelectionMimeData::last_ = nullptr;
+
+static void detachSelectionData(const QTextDocument* doc) {
+    SelectionMimeData::detach(doc);
+}
+/*************************/
+void TextEdit::keepSelectionData() {
+    detachSelectionData(document());
+}
+/*************************/
 // QPlainTextEdit doesn't give a plain text to the clipboard on copying/cutting
-// but we're interested only in plain text.
+// but we're interested only in plain text. Here, the text is copied at once
+// because the document may be edited before it's pasted.
 void TextEdit::copy() {
     QTextCursor cursor = textCursor();
     if (cursor.hasSelection())
-        QApplication::clipboard()->setText(cursor.selection().toPlainText());
+        QApplication::clipboard()->setText(plainSelection(cursor));
     else
         copyColumn();
 }
 void TextEdit::cut() {
+    keepSelectionData();
     QTextCursor cursor = textCursor();
     if (cursor.hasSelection()) {
         keepTxtCurHPos_ = false;
         txtCurHPos_ = -1;
-        QApplication::clipboard()->setText(cursor.selection().toPlainText());
+        QApplication::clipboard()->setText(plainSelection(cursor));
         cursor.removeSelectedText();
     }
     else
@@ -1229,6 +1381,7 @@ void TextEdit::cut() {
 }
 /*************************/
 void TextEdit::deleteText() {
+    keepSelectionData();
     if (textCursor().hasSelection()) {
         keepTxtCurHPos_ = false;
         txtCurHPos_ = -1;
@@ -1256,7 +1409,10 @@ void TextEdit::undo() {
 
     keepTxtCurHPos_ = false;
     txtCurHPos_ = -1;
+    keepSelectionData();
+    undoReplaying_ = true;  // not a new change for the undo memory
     QPlainTextEdit::undo();
+    undoReplaying_ = false;
 
     /* because of a bug in Qt, "QPlainTextEdit::selectionChanged()"
        may not be emitted after undoing */
@@ -1267,7 +1423,10 @@ void TextEdit::redo() {
     removeColumnHighlight();
     keepTxtCurHPos_ = false;
     txtCurHPos_ = -1;
+    keepSelectionData();
+    undoReplaying_ = true;
     QPlainTextEdit::redo();
+    undoReplaying_ = false;
 
     removeSelectionHighlights_ = true;
     selectionHlight();
@@ -1288,19 +1447,20 @@ void TextEdit::selectAll() {
 void TextEdit::insertPlainText(const QString& text) {
     keepTxtCurHPos_ = false;
     txtCurHPos_ = -1;
+    keepSelectionData();
     QPlainTextEdit::insertPlainText(text);
 }
 /*************************/
 QMimeData* TextEdit::createMimeDataFromSelection() const {
-    /* Prevent a rich text in the selection clipboard when the text
-       is selected by the mouse. Also, see TextEdit::copy()/cut(). */
+    /* Prevent a rich text in the selection clipboard when the text is selected
+       by the mouse. Also, see TextEdit::copy()/cut(). A large text isn't copied
+       here because this is called with every change of a mouse selection. */
     QTextCursor cursor = textCursor();
-    if (cursor.hasSelection()) {
-        QMimeData* mimeData = new QMimeData;
-        mimeData->setText(cursor.selection().toPlainText());
-        return mimeData;
-    }
-    return nullptr;
+    if (!cursor.hasSelection())
+        return nullptr;
+    if (cursor.selectionEnd() - cursor.selectionStart() < MIN_LAZY_SELECTION)
+        return new SelectionMimeData(plainSelection(cursor));
+    return new SelectionMimeData(cursor);
 }
 /*************************/
 static bool containsPlainText(const QStringList& list) {
@@ -1332,6 +1492,7 @@ void TextEdit::insertFromMimeData(const QMimeData* source) {
     keepTxtCurHPos_ = false;
     if (source == nullptr)
         return;
+    keepSelectionData();
     if (source->hasUrls()) {
         const QList<QUrl> urlList = source->urls();
         bool multiple(urlList.count() > 1);
@@ -1364,14 +1525,104 @@ void TextEdit::insertFromMimeData(const QMimeData* source) {
             }
         }
     }
-    else if (containsPlainText(source->formats()) && !source->text().isEmpty())
-        QPlainTextEdit::insertFromMimeData(source);
+    else if (containsPlainText(source->formats())) {
+        const QString text = source->text();
+        if (text.size() > PASTE_CHUNK_SIZE)
+            pasteInChunks(text);
+        else if (!text.isEmpty())
+            QPlainTextEdit::insertFromMimeData(source);
+    }
+}
+/*************************/
+// Pasting a huge text at once would freeze the window for a long time. Instead, it's
+// inserted in chunks, with a return to the event loop after each chunk, while a modal
+// progress dialog blocks other edits. All chunks are inserted inside one edit block,
+// so that the layout and highlighting are updated only at the end and there is a
+// single undo step. Canceling undoes what is inserted. Because the edit block stays
+// open across the event loop, the timers of this text edit and its layout wait, and
+// the window is told to pause auto-saving (see "pasting()").
+void TextEdit::pasteInChunks(const QString& text) {
+    if (pasteTimerId_ != 0)
+        return;
+    txtCurHPos_ = -1;
+    pasteText_ = text;
+    pastePos_ = 0;
+    reserveUndoMemory(pasteText_.size() + textCursor().selectionEnd() - textCursor().selectionStart());
+    pasteCursor_ = textCursor();
+    pasteCursor_.beginEditBlock();
+
+    pasteProgress_ = new QProgressDialog(tr("Pasting..."), tr("Cancel"), 0, 100, this);
+    pasteProgress_->setWindowModality(Qt::WindowModal);
+    pasteProgress_->setMinimumDuration(0);
+    pasteProgress_->setAutoReset(false);
+    pasteProgress_->setAutoClose(false);
+    connect(pasteProgress_, &QProgressDialog::canceled, this, [this] { finishChunkedPaste(true); });
+    pasteProgress_->show();
+
+    if (auto layout = qobject_cast<TextLayout*>(document()->documentLayout()))
+        layout->setPaused(true);
+    pasteTimerId_ = startTimer(0);
+    emit pasting(true);
+}
+/*************************/
+void TextEdit::pasteNextChunk() {
+    const qsizetype size = pasteText_.size();
+    qsizetype end = std::min(pastePos_ + PASTE_CHUNK_SIZE, size);
+    if (end < size) {
+        /* split after a line end if possible, but never inside "\r\n" or a surrogate pair */
+        const qsizetype lineEnd = pasteText_.lastIndexOf(QLatin1Char('\n'), end - 1);
+        if (lineEnd >= pastePos_)
+            end = lineEnd + 1;
+        else if (pasteText_.at(end - 1) == QLatin1Char('\r') || pasteText_.at(end - 1).isHighSurrogate())
+            ++end;
+    }
+    pasteCursor_.insertText(pasteText_.mid(pastePos_, end - pastePos_));
+    pastePos_ = end;
+
+    if (pastePos_ >= size)
+        finishChunkedPaste(false);
+    else if (pasteProgress_)
+        pasteProgress_->setValue(static_cast<int>(pastePos_ * 100 / size));
+}
+/*************************/
+void TextEdit::finishChunkedPaste(bool canceled) {
+    if (pasteTimerId_ == 0)
+        return;
+    killTimer(pasteTimerId_);
+    pasteTimerId_ = 0;
+
+    const bool inserted = pastePos_ > 0;
+    pasteCursor_.endEditBlock();  // the layout and highlighting are updated here
+    if (canceled) {
+        if (inserted) {
+            undoReplaying_ = true;
+            document()->undo(&pasteCursor_);
+            undoReplaying_ = false;
+            /* the canceled paste shouldn't be redone */
+            document()->clearUndoRedoStacks(QTextDocument::RedoStack);
+        }
+    }
+    else {
+        setTextCursor(pasteCursor_);
+        ensureCursorVisible();
+    }
+    pasteText_.clear();
+    pastePos_ = 0;
+    pasteCursor_ = QTextCursor();
+    if (auto layout = qobject_cast<TextLayout*>(document()->documentLayout()))
+        layout->setPaused(false);
+    emit pasting(false);
+
+    if (pasteProgress_) {
+        pasteProgress_->disconnect(this);
+        pasteProgress_->deleteLater();
+    }
 }
 /*************************/
 void TextEdit::copyColumn() {
     QString res;
     for (auto const& extra : std::as_const(colSel_)) {
-        res.append(extra.cursor.selection().toPlainText());
+        res.append(plainSelection(extra.cursor));
         res.append('\n');
     }
     if (!res.isEmpty()) {
@@ -1469,6 +1720,12 @@ void TextEdit::pasteOnColumn() {
     removeColumnHighlight();
 }
 /*************************/
+void TextEdit::inputMethodEvent(QInputMethodEvent* event) {
+    if (!isReadOnly() && (!event->commitString().isEmpty() || !event->preeditString().isEmpty()))
+        keepSelectionData();  // the selection may be replaced
+    QPlainTextEdit::inputMethodEvent(event);
+}
+/*************************/
 void TextEdit::keyReleaseEvent(QKeyEvent* event) {
     /* deal with hyperlinks */
     if (highlighter_ && event->key() == Qt::Key_Control && viewport()->cursor().shape() != Qt::IBeamCursor) {
@@ -1631,6 +1888,12 @@ void TextEdit::resizeEvent(QResizeEvent* event) {
 void TextEdit::timerEvent(QTimerEvent* event) {
     QPlainTextEdit::timerEvent(event);
 
+    if (pasteTimerId_ != 0) {
+        /* while an edit block is open for pasting, other timers wait (they're killed when handled) */
+        if (event->timerId() == pasteTimerId_)
+            pasteNextChunk();
+        return;
+    }
     if (event->timerId() == resizeTimerId_) {
         killTimer(event->timerId());
         resizeTimerId_ = 0;
@@ -1642,6 +1905,44 @@ void TextEdit::timerEvent(QTimerEvent* event) {
         selectionHlight();
         emit selChanged();
     }
+    else if (event->timerId() == matchIndexTimerId_) {
+        killTimer(event->timerId());
+        matchIndexTimerId_ = 0;
+        reindexEditedBlocks();
+    }
+    else if (event->timerId() == updateTimerId_) {
+        killTimer(event->timerId());
+        updateTimerId_ = 0;
+        runScheduledUpdates();
+    }
+    else if (event->timerId() == zoomTimerId_) {
+        killTimer(zoomTimerId_);
+        zoomTimerId_ = 0;
+        applyZoom();
+    }
+}
+/*************************/
+// Holding an arrow key or dragging a selection moves the cursor many times. Instead of
+// updating the current line, the cursor position and bracket matches on each move,
+// the updates are collected and done together at most once per frame.
+void TextEdit::scheduleUpdates(int updates) {
+    scheduledUpdates_ |= updates;
+    if (updateTimerId_ == 0)
+        updateTimerId_ = startTimer(FRAME_INTERVAL);
+}
+/*************************/
+void TextEdit::runScheduledUpdates() {
+    const int updates = scheduledUpdates_;
+    scheduledUpdates_ = 0;
+    if (updates & CursorUpdate) {
+        if (!lineNumberArea_->isHidden())
+            highlightCurrentLine();
+        emit cursorMoved();
+    }
+    /* brackets are matched after the current line is highlighted,
+       and selection highlights have their own (longer) timer */
+    if (updates & BracketUpdate)
+        emit updateBracketMatching();
 }
 /**********************
 ***** Paint event *****
@@ -1672,6 +1973,13 @@ void TextEdit::paintEvent(QPaintEvent* event) {
 
     QRect er = event->rect();
     QRect viewportRect = viewport()->rect();
+    if (pendingZoom_ > 0 && document()->defaultFont().pointSizeF() > 0) {  // see zooming()
+        const qreal scale = pendingZoom_ / document()->defaultFont().pointSizeF();
+        painter.scale(scale, scale);
+        er = QRectF(QPointF(er.topLeft()) / scale, QSizeF(er.size()) / scale).toAlignedRect();
+        viewportRect = QRectF(QPointF(viewportRect.topLeft()) / scale, QSizeF(viewportRect.size()) / scale)
+                           .toAlignedRect();
+    }
     double maximumWidth = document()->documentLayout()->documentSize().width();
     painter.setBrushOrigin(offset);
 
@@ -1682,6 +1990,17 @@ void TextEdit::paintEvent(QPaintEvent* event) {
 
     bool editable = !isReadOnly();
     QAbstractTextDocumentLayout::PaintContext context = getPaintContext();
+
+    /* font metrics needed by the indentation and position lines */
+    const QFontMetricsF fm(document()->defaultFont());
+    const double docMargin = document()->documentMargin();
+    const double tabWidth = fm.horizontalAdvance(textTab_);
+    const double spaceWidth = tabWidth / static_cast<double>(std::max(static_cast<int>(textTab_.size()), 1));
+    const bool drawRuler = vLineDistance_ >= 10 && QFontInfo(document()->defaultFont()).fixedPitch();
+    const double rulerSpace = fm.horizontalAdvance(' ') * static_cast<double>(vLineDistance_);
+    QList<QLine> indentLines, rulerLines;
+    QList<QRectF> foldMarks;  // the places of ellipses after folded headers
+
     QTextBlock block = firstVisibleBlock();
     while (block.isValid()) {
         QRectF r = blockBoundingRect(block).translated(offset);
@@ -1803,69 +2122,51 @@ void TextEdit::paintEvent(QPaintEvent* event) {
                 layout->drawCursor(&painter, offset, cpos, cursorWidth());
             }
 
-            /* indentation and position lines should be drawn after selections */
-            if (drawIndetLines_) {
-                QRegularExpressionMatch match;
-                if (block.text().indexOf(QRegularExpression("\\s+"), 0, &match) == 0) {
-                    painter.save();
-                    painter.setOpacity(0.18);
-                    QTextCursor cur = textCursor();
-                    cur.setPosition(match.capturedLength() + block.position());
-                    QFontMetricsF fm = QFontMetricsF(document()->defaultFont());
-                    int yTop = std::round(r.topLeft().y());
-                    int yBottom = std::round(r.height() >= static_cast<double>(2) * fm.lineSpacing()
-                                                 ? yTop + fm.height()
-                                                 : r.bottomLeft().y() - static_cast<double>(1));
-                    double tabWidth = fm.horizontalAdvance(textTab_);
-                    if (rtl) {
-                        double leftMost = cursorRect(cur).left();
-                        double x = r.topRight().x();
-                        x -= tabWidth;
-                        while (x >= leftMost) {
-                            painter.drawLine(QLine(std::round(x), yTop, std::round(x), yBottom));
+            if (!folds_.isEmpty() && layout->lineCount() > 0 && isFolded(block)) {
+                const QRectF lr = layout->lineAt(layout->lineCount() - 1).naturalTextRect().translated(offset);
+                const double markWidth = fm.horizontalAdvance(QStringLiteral("...")) + spaceWidth;
+                foldMarks.append(QRectF(rtl ? lr.left() - spaceWidth - markWidth : lr.right() + spaceWidth, lr.top(),
+                                        markWidth, lr.height()));
+            }
+
+            /* indentation and position lines should be drawn after selections;
+               they are collected here and drawn together after the loop */
+            if (drawIndetLines_ || drawRuler) {
+                int yTop = std::round(r.topLeft().y());
+                int yBottom = std::round(r.height() >= static_cast<double>(2) * fm.lineSpacing()
+                                             ? yTop + fm.height()
+                                             : r.bottomLeft().y() - static_cast<double>(1));
+                if (drawIndetLines_) {
+                    if (int indent = indentLevel(block)) {
+                        if (rtl) {
+                            double leftMost = r.topRight().x() - docMargin - indent * spaceWidth;
+                            double x = r.topRight().x();
                             x -= tabWidth;
+                            while (x >= leftMost) {
+                                indentLines.append(QLine(std::round(x), yTop, std::round(x), yBottom));
+                                x -= tabWidth;
+                            }
                         }
-                    }
-                    else {
-                        double rightMost = cursorRect(cur).right();
-                        double x = r.topLeft().x();
-                        x += tabWidth;
-                        while (x <= rightMost) {
-                            painter.drawLine(QLine(std::round(x), yTop, std::round(x), yBottom));
+                        else {
+                            double rightMost = r.topLeft().x() + docMargin + indent * spaceWidth;
+                            double x = r.topLeft().x();
                             x += tabWidth;
+                            while (x <= rightMost) {
+                                indentLines.append(QLine(std::round(x), yTop, std::round(x), yBottom));
+                                x += tabWidth;
+                            }
                         }
                     }
-                    painter.restore();
-                }
-            }
-            if (vLineDistance_ >= 10 && !rtl && QFontInfo(document()->defaultFont()).fixedPitch()) {
-                painter.save();
-                QColor col;
-                if (darkValue_ > -1) {
-                    col = QColor(65, 154, 255);
-                    col.setAlpha(90);
-                }
-                else {
-                    col = Qt::blue;
-                    col.setAlpha(70);
                 }
-                painter.setPen(col);
-                QTextCursor cur = textCursor();
-                cur.setPosition(block.position());
-                QFontMetricsF fm = QFontMetricsF(document()->defaultFont());
-                double rulerSpace = fm.horizontalAdvance(' ') * static_cast<double>(vLineDistance_);
-                int yTop = std::round(r.topLeft().y());
-                int yBottom = std::round(r.height() >= static_cast<double>(2) * fm.lineSpacing()
-                                             ? yTop + fm.height()
-                                             : r.bottomLeft().y() - static_cast<double>(1));
-                double rightMost = er.right();
-                double x = static_cast<double>(cursorRect(cur).right());
-                x += rulerSpace;
-                while (x <= rightMost) {
-                    painter.drawLine(QLine(std::round(x), yTop, std::round(x), yBottom));
+                if (drawRuler && !rtl) {
+                    double rightMost = er.right();
+                    double x = r.topLeft().x() + docMargin;
                     x += rulerSpace;
+                    while (x <= rightMost) {
+                        rulerLines.append(QLine(std::round(x), yTop, std::round(x), yBottom));
+                        x += rulerSpace;
+                    }
                 }
-                painter.restore();
             }
         }
 
@@ -1875,6 +2176,37 @@ void TextEdit::paintEvent(QPaintEvent* event) {
         block = block.next();
     }
 
+    if (!indentLines.isEmpty()) {
+        painter.save();
+        painter.setOpacity(0.18);
+        painter.drawLines(indentLines);
+        painter.restore();
+    }
+    if (!foldMarks.isEmpty()) {
+        painter.save();
+        painter.setPen(darkValue_ > -1 ? QColor(200, 200, 200) : QColor(100, 100, 100));
+        for (const auto& mark : std::as_const(foldMarks)) {
+            painter.drawRoundedRect(mark.adjusted(0.5, 1.5, -0.5, -1.5), 3, 3);
+            painter.drawText(mark, Qt::AlignCenter, QStringLiteral("..."));
+        }
+        painter.restore();
+    }
+    if (!rulerLines.isEmpty()) {
+        painter.save();
+        QColor col;
+        if (darkValue_ > -1) {
+            col = QColor(65, 154, 255);
+            col.setAlpha(90);
+        }
+        else {
+            col = Qt::blue;
+            col.setAlpha(70);
+        }
+        painter.setPen(col);
+        painter.drawLines(rulerLines);
+        painter.restore();
+    }
+
     if (backgroundVisible() && !block.isValid() && offset.y() <= er.bottom() &&
         (centerOnScroll() || verticalScrollBar()->maximum() == verticalScrollBar()->minimum())) {
         painter.fillRect(QRect(QPoint(static_cast<int>(er.left()), static_cast<int>(offset.y())), er.bottomRight()),
@@ -1884,6 +2216,90 @@ void TextEdit::paintEvent(QPaintEvent* event) {
 /*********************************
 ***** End of the paint event *****
 **********************************/
+/*************************/
+void TextEdit::setHighlighter(QSyntaxHighlighter* h) {
+    highlighter_ = h;
+    matchedBrackets_ = false;
+    /* folding depends on highlighting */
+    if (h) {
+        connect(h, &QObject::destroyed, this, [this] {
+            unfoldAll();
+            if (!lineNumberArea_->isHidden())
+                updateLineNumberAreaWidth(0);
+        });
+    }
+    else
+        unfoldAll();
+    if (!lineNumberArea_->isHidden())
+        updateLineNumberAreaWidth(0);
+}
+/*************************/
+void TextEdit::setShowOverview(bool show) {
+    vScrollBar_->setOverview(show);
+}
+/*************************/
+void TextEdit::setDrawIndetLines(bool draw) {
+    if (draw == drawIndetLines_)
+        return;
+    drawIndetLines_ = draw;
+    indentLevels_.clear();
+    if (draw)
+        connect(document(), &QTextDocument::contentsChange, this, &TextEdit::updateIndentLevels);
+    else
+        disconnect(document(), &QTextDocument::contentsChange, this, &TextEdit::updateIndentLevels);
+}
+/*************************/
+// Returns the width of the leading whitespace of the block in columns.
+// The result is cached and invalidated by updateIndentLevels().
+int TextEdit::indentLevel(const QTextBlock& block) {
+    const int count = document()->blockCount();
+    if (indentLevels_.size() != count)
+        indentLevels_ = QList<int>(count, -1);
+    int& level = indentLevels_[block.blockNumber()];
+    if (level < 0) {
+        const int tabSize = std::max(static_cast<int>(textTab_.size()), 1);
+        const QString text = block.text();
+        int col = 0;
+        for (const QChar& c : text) {
+            if (c == QLatin1Char(' '))
+                ++col;
+            else if (c == QLatin1Char('\t'))
+                col += tabSize - col % tabSize;
+            else
+                break;
+        }
+        level = col;
+    }
+    return level;
+}
+/*************************/
+// Keeps the cached indentation widths in sync with the document by
+// shifting them on block insertion/removal and resetting the changed blocks.
+void TextEdit::updateIndentLevels(int position, int /*charsRemoved*/, int charsAdded) {
+    if (indentLevels_.isEmpty())
+        return;  // nothing is cached yet
+    const int count = document()->blockCount();
+    QTextBlock block = document()->findBlock(position);
+    if (!block.isValid()) {
+        indentLevels_.clear();
+        return;
+    }
+    const int first = block.blockNumber();
+    QTextBlock lastBlock = document()->findBlock(position + charsAdded);
+    const int last = lastBlock.isValid() ? lastBlock.blockNumber() : count - 1;
+    const int size = indentLevels_.size();
+    const int diff = count - size;
+    if (first >= size || (diff < 0 && first + 1 - diff > size)) {  // a precaution
+        indentLevels_.clear();
+        return;
+    }
+    if (diff > 0)
+        indentLevels_.insert(first + 1, diff, -1);
+    else if (diff < 0)
+        indentLevels_.remove(first + 1, -diff);
+    for (int i = first; i <= last; ++i)
+        indentLevels_[i] = -1;
+}
 
 void TextEdit::highlightCurrentLine() {
     /* keep yellow, green and blue highlights
@@ -1904,6 +2320,31 @@ void TextEdit::highlightCurrentLine() {
     setExtraSelections(es);
 }
 /*************************/
+// Draws a triangle that points to the text if the region is folded and downward otherwise.
+static void drawFoldMarker(QPainter* p, const QRectF& rect, bool folded, bool rtl) {
+    const double s = std::min(rect.width(), rect.height()) / 2.0;
+    const QPointF c = rect.center();
+    QPolygonF triangle;
+    if (!folded) {
+        triangle << QPointF(c.x() - s / 2, c.y() - s / 4) << QPointF(c.x() + s / 2, c.y() - s / 4)
+                 << QPointF(c.x(), c.y() + s / 2);
+    }
+    else if (rtl) {
+        triangle << QPointF(c.x() + s / 4, c.y() - s / 2) << QPointF(c.x() + s / 4, c.y() + s / 2)
+                 << QPointF(c.x() - s / 2, c.y());
+    }
+    else {
+        triangle << QPointF(c.x() - s / 4, c.y() - s / 2) << QPointF(c.x() - s / 4, c.y() + s / 2)
+                 << QPointF(c.x() + s / 2, c.y());
+    }
+    p->save();
+    p->setRenderHint(QPainter::Antialiasing);
+    p->setBrush(p->pen().color());
+    p->setPen(Qt::NoPen);
+    p->drawPolygon(triangle);
+    p->restore();
+}
+/*************************/
 void TextEdit::lineNumberAreaPaintEvent(QPaintEvent* event) {
     QPainter painter(lineNumberArea_);
     QColor currentBlockFg, currentLineBg, currentLineFg;
@@ -1924,7 +2365,10 @@ void TextEdit::lineNumberAreaPaintEvent(QPaintEvent* event) {
 
     bool rtl(QApplication::layoutDirection() == Qt::RightToLeft);
     int w = lineNumberArea_->width();
-    int left = rtl ? 3 : 0;
+    /* the fold markers are drawn between line numbers and text */
+    const int fw = foldMarginWidth();
+    int left = rtl ? 3 + fw : 0;
+    int numW = w - 3 - fw;
 
     QTextBlock block = firstVisibleBlock();
     int blockNumber = block.blockNumber();
@@ -1953,19 +2397,24 @@ void TextEdit::lineNumberAreaPaintEvent(QPaintEvent* event) {
                 else {
                     int cur = cursorRect().center().y();
                     painter.fillRect(0, cur - h / 2, w, h, currentLineBg);
-                    painter.drawText(left, cur - h / 2, w - 3, h, Qt::AlignRight, rtl ? "↲" : "↳");
+                    painter.drawText(left, cur - h / 2, numW, h, Qt::AlignRight, rtl ? "↲" : "↳");
                     painter.setPen(currentBlockFg);
                     if (tmp.movePosition(QTextCursor::Up, QTextCursor::MoveAnchor))  // always true
                     {
                         tmp.movePosition(QTextCursor::StartOfLine, QTextCursor::MoveAnchor);
                         if (!tmp.atBlockStart()) {
                             cur = cursorRect(tmp).center().y();
-                            painter.drawText(left, cur - h / 2, w - 3, h, Qt::AlignRight, number);
+                            painter.drawText(left, cur - h / 2, numW, h, Qt::AlignRight, number);
                         }
                     }
                 }
             }
-            painter.drawText(left, top, w - 3, h, Qt::AlignRight, number);
+            painter.drawText(left, top, numW, h, Qt::AlignRight, number);
+            if (fw > 0) {
+                const bool folded = isFolded(block);
+                if (folded || isFoldHeader(block))
+                    drawFoldMarker(&painter, QRectF(rtl ? 0 : w - fw, top, fw, h), folded, rtl);
+            }
             if (blockNumber == curBlock)
                 painter.restore();
         }
@@ -1996,7 +2445,7 @@ void TextEdit::onUpdateRequesting(const QRect& /*rect*/, int dy) {
     /* because brackets may have been invisible before,
        FPwin::matchBrackets() should be called here */
     if (!matchedBrackets_ && isVisible())
-        emit updateBracketMatching();
+        scheduleUpdates(BracketUpdate);
 }
 /*************************/
 void TextEdit::onSelectionChanged() {
@@ -2006,7 +2455,7 @@ void TextEdit::onSelectionChanged() {
     QTextCursor cur = textCursor();
     if (!cur.hasSelection()) {
         if (cur.position() == prevPos_ && cur.position() < prevAnchor_)
-            emit updateBracketMatching();
+            scheduleUpdates(BracketUpdate);
         prevAnchor_ = prevPos_ = -1;
     }
     else {
@@ -2036,26 +2485,41 @@ void TextEdit::zooming(float range) {
     keepTxtCurHPos_ = false;
     txtCurHPos_ = -1;
 
-    QFont f = document()->defaultFont();
+    /* Changing the font clears the layouts of all blocks, shapes the visible text again
+       and may need reformatting. So, while zooming in several steps, the text is only
+       scaled in paintEvent() and the font is changed when zooming stops. */
+    qreal size = pendingZoom_ > 0 ? pendingZoom_ : document()->defaultFont().pointSizeF();
     if (range == 0.f)  // means unzooming
-    {
-        setEditorFont(font_, false);
-        if (font_.pointSizeF() < f.pointSizeF())
-            emit zoomedOut(this);  // see the explanation below
-    }
+        size = font_.pointSizeF();
     else {
-        const float newSize = static_cast<float>(f.pointSizeF()) + range;
-        if (newSize <= 0)
+        size += static_cast<qreal>(range);
+        if (size <= 0)
             return;
-        f.setPointSizeF(static_cast<double>(newSize));
+    }
+    pendingZoom_ = size;
+    if (zoomTimerId_)
+        killTimer(zoomTimerId_);
+    zoomTimerId_ = startTimer(ZOOM_DELAY);
+    viewport()->update();
+}
+/*************************/
+void TextEdit::applyZoom() {
+    const qreal size = pendingZoom_;
+    pendingZoom_ = -1;
+    QFont f = document()->defaultFont();
+    const qreal oldSize = f.pointSizeF();
+    if (size == font_.pointSizeF())
+        setEditorFont(font_, false);
+    else {
+        f.setPointSizeF(size);
         setEditorFont(f, false);
-
-        /* if this is a zoom-out, the text will need
-           to be formatted and/or highlighted again */
-        if (range < 0)
-            emit zoomedOut(this);
     }
 
+    /* if this is a zoom-out, the text will need
+       to be formatted and/or highlighted again */
+    if (size < oldSize)
+        emit zoomedOut(this);
+
     /* due to a Qt bug, this is needed for the
        scrollbar range to be updated correctly */
     adjustScrollbars();
@@ -2070,7 +2534,7 @@ void TextEdit::showEvent(QShowEvent* event) {
     QPlainTextEdit::showEvent(event);
     emit updateRect();
     if (!matchedBrackets_)
-        emit updateBracketMatching();
+        scheduleUpdates(BracketUpdate);
 }
 /*************************/
 void TextEdit::sortLines(bool reverse) {
@@ -2085,9 +2549,6 @@ void TextEdit::sortLines(bool reverse) {
     const int anchorPos = cursor.anchor();
     const int curPos = cursor.position();
 
-    // Begin block so the whole replace is undoable in one step
-    cursor.beginEditBlock();
-
     // Expand selection to whole lines
     cursor.setPosition(std::min(anchorPos, curPos));
     cursor.movePosition(QTextCursor::StartOfBlock);
@@ -2105,15 +2566,8 @@ void TextEdit::sortLines(bool reverse) {
     if (reverse)
         std::reverse(lines.begin(), lines.end());
 
-    // Replace the selected text with sorted lines
-    cursor.removeSelectedText();
-    for (int i = 0; i < lines.size(); ++i) {
-        cursor.insertText(lines.at(i));
-        if (i < lines.size() - 1)
-            cursor.insertBlock();
-    }
-
-    cursor.endEditBlock();
+    // Replace the selected text with sorted lines as a single edit
+    replaceRange(cursor.selectionStart(), cursor.selectionEnd(), lines.join(QChar(QChar::ParagraphSeparator)));
 }
 
 void TextEdit::rmDupeSort(bool reverse) {
@@ -2128,8 +2582,6 @@ void TextEdit::rmDupeSort(bool reverse) {
     const int anchorPos = cursor.anchor();
     const int curPos = cursor.position();
 
-    cursor.beginEditBlock();
-
     cursor.setPosition(std::min(anchorPos, curPos));
     cursor.movePosition(QTextCursor::StartOfBlock);
     cursor.setPosition(std::max(anchorPos, curPos), QTextCursor::KeepAnchor);
@@ -2149,15 +2601,7 @@ void TextEdit::rmDupeSort(bool reverse) {
     if (reverse)
         std::reverse(lines.begin(), lines.end());
 
-    cursor.removeSelectedText();
-    for (int i = 0; i < lines.size(); ++i) {
-        cursor.insertText(lines.at(i));
-        if (i < lines.size() - 1) {
-            cursor.insertBlock();
-        }
-    }
-
-    cursor.endEditBlock();
+    replaceRange(cursor.selectionStart(), cursor.selectionEnd(), lines.join(QChar(QChar::ParagraphSeparator)));
 }
 
 void TextEdit::spaceDupeSort(bool reverse) {
@@ -2169,12 +2613,8 @@ void TextEdit::spaceDupeSort(bool reverse) {
     if (cursor.anchor() == cursor.position())
         return;
 
-    cursor.beginEditBlock();
-
     QString rawSelection = cursor.selectedText();
 
-    cursor.removeSelectedText();
-
     rawSelection.replace(QChar(QChar::ParagraphSeparator), QLatin1Char(' '));
     rawSelection.replace(QChar::CarriageReturn, QLatin1Char(' '));
     rawSelection.replace(QChar::LineFeed, QLatin1Char(' '));
@@ -2196,9 +2636,7 @@ void TextEdit::spaceDupeSort(bool reverse) {
 
     QString singleLine = tokens.join(QLatin1Char(' '));
 
-    cursor.insertText(singleLine);
-
-    cursor.endEditBlock();
+    replaceRange(cursor.selectionStart(), cursor.selectionEnd(), singleLine);
 }
 
 /************************************************************
@@ -2511,7 +2949,7 @@ void TextEdit::mousePressEvent(QMouseEvent* event) {
                 if (txtCur.hasSelection()) {
                     QClipboard* cl = QApplication::clipboard();
                     if (cl->supportsSelection())
-                        cl->setText(txtCur.selection().toPlainText(), QClipboard::Selection);
+                        cl->setMimeData(createMimeDataFromSelection(), QClipboard::Selection);
                 }
                 event->accept();
                 return;
@@ -2595,7 +3033,7 @@ void TextEdit::mouseDoubleClickEvent(QMouseEvent* event) {
             if (txtCur.hasSelection()) {
                 QClipboard* cl = QApplication::clipboard();
                 if (cl->supportsSelection())
-                    cl->setText(txtCur.selection().toPlainText(), QClipboard::Selection);
+                    cl->setMimeData(createMimeDataFromSelection(), QClipboard::Selection);
             }
             event->accept();
         }
@@ -2624,14 +3062,186 @@ void TextEdit::removeColumnHighlight() {
     selectionTimerId_ = startTimer(UPDATE_INTERVAL);
 }
 /*************************/
-int TextEdit::selectionSize() const {
-    int res = textCursor().selectedText().size();
-    if (res > 0)
-        return res;
-    for (auto const& extra : std::as_const(colSel_)) {
-        res += extra.cursor.selectedText().size();
+static int countWords(const QTextDocument* doc, int start, int end) {
+    int words = 0;
+    QTextBlock block = doc->findBlock(start);
+    while (block.isValid() && block.position() < end) {
+        const QString text = block.text();
+        const int to = std::min(static_cast<int>(text.size()), end - block.position());
+        bool inWord = false;  // a line end separates words
+        for (int i = std::max(0, start - block.position()); i < to; ++i) {
+            if (text.at(i).isSpace())
+                inWord = false;
+            else if (!inWord) {
+                inWord = true;
+                ++words;
+            }
+        }
+        block = block.next();
     }
-    return res;
+    return words;
+}
+
+TextEdit::selectionStats TextEdit::selectionInfo() const {
+    selectionStats stats{0, 0, 0};
+    QList<QPair<int, int>> ranges;
+    const QTextCursor cur = textCursor();
+    if (cur.hasSelection())
+        ranges.append({cur.selectionStart(), cur.selectionEnd()});
+    else {
+        for (auto const& extra : std::as_const(colSel_)) {
+            if (extra.cursor.hasSelection())
+                ranges.append({extra.cursor.selectionStart(), extra.cursor.selectionEnd()});
+        }
+    }
+
+    /* like "QTextCursor::selectedText()", a line end is counted as a character */
+    const QTextDocument* doc = document();
+    for (const auto& range : std::as_const(ranges)) {
+        stats.chars += range.second - range.first;
+        stats.lines += doc->findBlock(range.second - 1).blockNumber() - doc->findBlock(range.first).blockNumber() + 1;
+    }
+    if (stats.chars > MAX_WORD_COUNTED_SELECTION)
+        stats.words = -1;
+    else {
+        for (const auto& range : std::as_const(ranges))
+            stats.words += countWords(doc, range.first, range.second);
+    }
+    return stats;
+}
+/*************************/
+void TextEdit::setSearchMarkers(const QString& str, QTextDocument::FindFlags flags, bool isRegex) {
+    if (str == searchMarkerStr_ && flags == searchMarkerFlags_ && isRegex == searchMarkerRegex_)
+        return;
+    if (searchMarkerStr_.isEmpty())
+        connect(document(), &QTextDocument::contentsChange, this, &TextEdit::outdateSearchMarkers);
+    else if (str.isEmpty())
+        disconnect(document(), &QTextDocument::contentsChange, this, &TextEdit::outdateSearchMarkers);
+    searchMarkerStr_ = str;
+    searchMarkerFlags_ = flags;
+    searchMarkerRegex_ = isRegex;
+    if (matchIndexTimerId_) {
+        killTimer(matchIndexTimerId_);
+        matchIndexTimerId_ = 0;
+    }
+    if (str.isEmpty()) {
+        /* a running indexer will be ignored */
+        vScrollBar_->clearMarkers(VScrollBar::SearchMarker);
+        return;
+    }
+    indexMatches();
+}
+/*************************/
+/* The markers are shifted by the scrollbar on editing but the matches of the edited
+   blocks may have changed. So, those blocks are re-indexed after a delay. */
+void TextEdit::outdateSearchMarkers(int position, int charsRemoved, int charsAdded) {
+    if (searchMarkerStr_.isEmpty())
+        return;
+    QTextDocument* doc = document();
+    if (charsRemoved == charsAdded && doc->revision() == markerRevision_)
+        return;  // only formats have changed (by the highlighter, for example)
+    markerRevision_ = doc->revision();
+
+    const int count = doc->blockCount();
+    const int diff = count - markerBlockCount_;
+    markerBlockCount_ = count;
+    QTextBlock block = doc->findBlock(position);
+    const int first = block.isValid() ? block.blockNumber() : 0;
+    block = doc->findBlock(position + charsAdded);
+    const int last = block.isValid() ? block.blockNumber() : count - 1;
+    if (editedFirst_ < 0) {
+        editedFirst_ = first;
+        editedLast_ = last;
+    }
+    else {
+        /* shift the previous range like the markers and add the new one to it */
+        if (editedFirst_ > first)
+            editedFirst_ = std::max(editedFirst_ + diff, first);
+        if (editedLast_ > first)
+            editedLast_ = std::max(editedLast_ + diff, first);
+        editedFirst_ = std::min(editedFirst_, first);
+        editedLast_ = std::min(std::max(editedLast_, last), count - 1);
+    }
+
+    if (matchIndexTimerId_)
+        killTimer(matchIndexTimerId_);
+    matchIndexTimerId_ = startTimer(MATCH_INDEX_INTERVAL);
+}
+/*************************/
+void TextEdit::indexMatches() {
+    if (searchMarkerStr_.isEmpty())
+        return;
+    if (matchIndexRunning_) {
+        /* only one indexer at a time; another one will be started when it finishes */
+        matchIndexOutdated_ = true;
+        return;
+    }
+    matchIndexRunning_ = true;
+    matchIndexOutdated_ = false;
+    editedFirst_ = editedLast_ = -1;
+    markerBlockCount_ = document()->blockCount();
+    markerRevision_ = document()->revision();
+    const QString str = searchMarkerStr_;
+    const QTextDocument::FindFlags flags = searchMarkerFlags_;
+    const bool isRegex = searchMarkerRegex_;
+    MatchIndexer* indexer = new MatchIndexer(snapshot(), str, flags, isRegex);
+    connect(indexer, &MatchIndexer::indexed, this, [this, str, flags, isRegex](const QList<int>& blocks, int revision) {
+        /* ignore the result if the search has changed in the meantime */
+        if (str != searchMarkerStr_ || flags != searchMarkerFlags_ || isRegex != searchMarkerRegex_)
+            return;
+        if (revision != snapshotRevision())
+            matchIndexOutdated_ = true;  // the edited blocks are unknown; index the whole text again
+        else if (!matchIndexOutdated_)
+            vScrollBar_->setMarkers(VScrollBar::SearchMarker, blocks);
+    });
+    connect(indexer, &QThread::finished, this, [this] {
+        matchIndexRunning_ = false;
+        if (matchIndexOutdated_)
+            indexMatches();
+    });
+    connect(indexer, &QThread::finished, indexer, &QObject::deleteLater);
+    connect(this, &QObject::destroyed, indexer, &QThread::requestInterruption);
+    indexer->start();
+}
+/*************************/
+/* Re-indexes only the edited blocks and keeps the (shifted) markers of other blocks.
+   The whole text is indexed in a thread if too many blocks are edited. */
+void TextEdit::reindexEditedBlocks() {
+    if (searchMarkerStr_.isEmpty() || editedFirst_ < 0)
+        return;
+    if (matchIndexRunning_ || editedLast_ - editedFirst_ > MAX_REINDEXED_BLOCKS) {
+        indexMatches();
+        return;
+    }
+    /* a multiline string may start in a previous block or end in a next one */
+    const int extra = searchMarkerRegex_ ? 0 : static_cast<int>(searchMarkerStr_.count(QLatin1Char('\n')));
+    const QTextDocument* doc = document();
+    const int first = std::max(editedFirst_ - extra, 0);
+    const int last = editedLast_;
+    const int end = std::min(last + extra, doc->blockCount() - 1);
+    editedFirst_ = editedLast_ = -1;
+
+    QString text;
+    QTextBlock block = doc->findBlockByNumber(first);
+    for (int i = first; i <= end && block.isValid(); ++i, block = block.next()) {
+        if (i > first)
+            text += QLatin1Char('\n');
+        text += block.text();
+    }
+    text.replace(QChar(QChar::Nbsp), QLatin1Char(' '));  // as in QTextDocument::toPlainText()
+    const QList<int> found = MatchIndexer::index(text, searchMarkerStr_, searchMarkerFlags_, searchMarkerRegex_, first);
+
+    /* the old markers are sorted */
+    const QList<int>& old = vScrollBar_->markers(VScrollBar::SearchMarker);
+    const qsizetype from = std::lower_bound(old.cbegin(), old.cend(), first) - old.cbegin();
+    const qsizetype to = std::upper_bound(old.cbegin(), old.cend(), last) - old.cbegin();
+    QList<int> markers = old.mid(0, from);
+    for (int b : std::as_const(found)) {
+        if (b <= last)
+            markers.append(b);
+    }
+    markers.append(old.mid(to));
+    vScrollBar_->setMarkers(VScrollBar::SearchMarker, markers);
 }
 /*************************/
 bool TextEdit::event(QEvent* event) {
@@ -3221,99 +3831,174 @@ void TextEdit::onContentsChange(int /*position*/, int charsRemoved, int charsAdd
 }
 /*************************/
 bool TextEdit::toSoftTabs() {
-    bool res = false;
-    QString tab = QString(QChar(QChar::Tabulation));
     QTextCursor orig = textCursor();
     orig.setPosition(orig.anchor());
     setTextCursor(orig);
-    QTextCursor found;
-    QTextCursor start = orig;
-    start.beginEditBlock();
-    start.setPosition(0);
-    while (!(found = finding(tab, start)).isNull()) {
-        res = true;
-        start.setPosition(found.anchor());
-        QString softTab = remainingSpaces(textTab_, start);
-        start.setPosition(found.position(), QTextCursor::KeepAnchor);
-        start.insertText(softTab);
-        start.setPosition(start.position());
-    }
-    start.endEditBlock();
+
+    /* Every tab is replaced by the spaces that fill it up to the next tab stop.
+       Since the text before a tab is already converted, its length is enough for
+       finding the number of spaces. The whole conversion is done as a single edit. */
+    const int tabSize = std::max(static_cast<int>(textTab_.size()), 1);
+    bool res = false;
+    QString newText;
+    QTextBlock block = document()->firstBlock();
+    while (block.isValid()) {
+        const QString text = block.text();
+        if (text.contains(QChar(QChar::Tabulation))) {
+            res = true;
+            const int lineStart = newText.size();
+            for (const QChar& c : text) {
+                if (c == QChar(QChar::Tabulation))
+                    newText += QString(tabSize - (newText.size() - lineStart) % tabSize, QLatin1Char(' '));
+                else
+                    newText += c;
+            }
+        }
+        else
+            newText += text;
+        block = block.next();
+        if (block.isValid())
+            newText += QChar(QChar::ParagraphSeparator);
+    }
+    if (res)
+        replaceRange(0, document()->characterCount() - 1, newText);
     return res;
 }
+/*************************/
+void TextEdit::setUndoMemoryLimit(int limit) {
+    undoMemoryLimit_ = static_cast<qint64>(std::max(limit, 0)) * 1024 * 1024;
+}
+/*************************/
+// Estimates the memory of the undo stack from the new text changes (removed texts are
+// kept by the undo commands, while inserted texts stay in the document's buffer).
+void TextEdit::onUndoContentsChange(int /*position*/, int charsRemoved, int charsAdded) {
+    /* the highlighter changes formats with equal numbers of removed and added characters */
+    if (charsRemoved == charsAdded && document()->revision() == undoRevision_)
+        return;
+    undoRevision_ = document()->revision();
+    const qint64 bytes = static_cast<qint64>(charsRemoved + charsAdded) * static_cast<qint64>(sizeof(QChar));
+    if (undoReplaying_)  // undoing or redoing doesn't add to the undo stack
+        replayedSize_ += bytes;
+    else if (document()->isUndoAvailable())  // not after setPlainText(), for example
+        undoSize_ += bytes;
+}
+/*************************/
+// QTextDocument can't drop its oldest undo commands directly, but it can clear only
+// its undo stack and keep its redo stack. So, when the next bulk edit would exceed
+// the limit, the recent steps that fit in half of the remaining memory are undone,
+// the older history is cleared, and those steps are redone. Nothing is asked here
+// because this is also called while saving (even by the auto-saving).
+void TextEdit::reserveUndoMemory(qint64 chars) {
+    const qint64 bytes = chars * static_cast<qint64>(sizeof(QChar));
+    if (undoMemoryLimit_ <= 0 || undoSize_ + bytes <= undoMemoryLimit_ || !document()->isUndoAvailable())
+        return;
+    QTextDocument* doc = document();
+    const qint64 keptMemory = (undoMemoryLimit_ - bytes) / 2;
+    const bool modified = doc->isModified();
+    const QTextCursor cursor = textCursor();
+    const int anchor = cursor.anchor();
+    const int pos = cursor.position();
+
+    undoReplaying_ = true;
+    qint64 kept = 0;
+    int steps = 0;
+    while (keptMemory > 0 && doc->isUndoAvailable()) {
+        replayedSize_ = 0;
+        doc->undo();
+        if (kept + replayedSize_ > keptMemory) {
+            doc->redo();  // this step is dropped too
+            break;
+        }
+        kept += replayedSize_;
+        ++steps;
+    }
+    doc->clearUndoRedoStacks(QTextDocument::UndoStack);
+    for (int i = 0; i < steps; ++i)
+        doc->redo();
+    undoReplaying_ = false;
+    undoSize_ = kept;
+
+    /* the text is the same again but the modification state is compared with
+       an index of the cleared undo stack; so, it's set again (a state that
+       was unmodified before the kept steps is considered as unreachable) */
+    const bool blocked = doc->blockSignals(true);
+    doc->setModified(!modified);
+    doc->blockSignals(blocked);
+    doc->setModified(modified);
+    QTextCursor cur = textCursor();
+    cur.setPosition(anchor);
+    cur.setPosition(pos, QTextCursor::KeepAnchor);
+    setTextCursor(cur);
+}
+/*************************/
+// Replaces the text between "start" and "end" with "text" by a single edit.
+// Only the part that differs from the current text is replaced, so that a bulk
+// operation is recorded as one small removal and one insertion in the undo stack.
+// Returns false if nothing is changed.
+bool TextEdit::replaceRange(int start, int end, const QString& text) {
+    if (start > end)
+        std::swap(start, end);
+    start = std::max(start, 0);
+    end = std::min(end, document()->characterCount() - 1);
+    if (start > end)
+        return false;
+
+    QTextCursor cursor(document());
+    cursor.setPosition(start);
+    cursor.setPosition(end, QTextCursor::KeepAnchor);
+    const QString oldText = cursor.selectedText();  // paragraph separators are U+2029
+    QString newText = text;
+    newText.replace(QLatin1Char('\n'), QChar(QChar::ParagraphSeparator));
+
+    const int oldSize = oldText.size();
+    const int newSize = newText.size();
+    const int maxCommon = std::min(oldSize, newSize);
+    int prefix = 0;
+    while (prefix < maxCommon && oldText.at(prefix) == newText.at(prefix))
+        ++prefix;
+    if (prefix > 0 && oldText.at(prefix - 1).isHighSurrogate())
+        --prefix;
+    int suffix = 0;
+    while (suffix < maxCommon - prefix && oldText.at(oldSize - 1 - suffix) == newText.at(newSize - 1 - suffix))
+        ++suffix;
+    if (suffix > 0 && oldText.at(oldSize - suffix).isLowSurrogate())
+        --suffix;
+
+    const int removed = oldSize - prefix - suffix;
+    const int added = newSize - prefix - suffix;
+    if (removed == 0 && added == 0)
+        return false;
+
+    keepSelectionData();
+    reserveUndoMemory(removed + added);
+    cursor.setPosition(start + prefix);
+    cursor.setPosition(start + oldSize - suffix, QTextCursor::KeepAnchor);
+    cursor.beginEditBlock();
+    cursor.insertText(newText.mid(prefix, added));
+    cursor.endEditBlock();
+    return true;
+}
 
 /*******************************************************************************
- ***** The scrollbar position can't be restored precisely in a direct way  *****
- ***** on reloading because text wrapping can make it unreliable. However, *****
- ***** we can restore it as precisely as possible by finding and restoring *****
- ***** the top, middle and bottom cursors in the following two functions.  *****
+ ***** The view is anchored to its first visible line, i.e., to a block and *****
+ ***** a line inside it. QPlainTextEdit scrolls by lines and the value of   *****
+ ***** its vertical scrollbar is the number of the first visible line, so   *****
+ ***** the anchor is found and restored without probing the text. Only the *****
+ ***** anchor block is laid out on restoring, even if the text is wrapped.  *****
  *******************************************************************************/
 TextEdit::viewPosition TextEdit::getViewPosition() const {
     viewPosition vPos;
-    if (auto vp = viewport()) {
-        QRect vr = vp->rect();
-
-        /* top cursor (immediately below the top edge of the viewport) */
-        int h = QFontMetrics(document()->defaultFont()).lineSpacing();
-        QTextCursor topCur = cursorForPosition(QPoint(vr.left(), vr.top() + h / 2));
-        if (topCur.block().textDirection() == Qt::RightToLeft)
-            topCur = cursorForPosition(QPoint(vr.right() + 1, vr.top() + h / 2));
-        QRect cRect = cursorRect(topCur);
-        int top = cRect.top();
-        vPos.topPos = topCur.position();
-
-        /* current cursor
-           NOTE: The top edge of its rectangle may be a little above the
-                 top edge of the viewport. So, the position of the top cursor
-                 is used for knowing whether it isn't above the viewport. */
-        int curPosition = textCursor().position();
-        if (curPosition >= vPos.topPos) {
-            cRect = cursorRect();
-            if (cRect.bottom() <= vr.bottom() && cRect.left() >= vr.left() && cRect.right() <= vr.right()) {
-                vPos.curPos = curPosition;  // otherwise, "vPos.curPos" is -1
-            }
-        }
-
-        /* bottom cursor (immediately above the bottom edge of the viewport) */
-        QTextCursor bottomCur = cursorForPosition(QPoint(vr.left(), vr.bottom()));
-        if (bottomCur.block().textDirection() == Qt::RightToLeft)
-            bottomCur = cursorForPosition(QPoint(vr.right() + 1, vr.bottom()));
-        cRect = cursorRect(bottomCur);
-        int bottom = cRect.bottom();
-        QTextCursor tmp = bottomCur;
-        while (!bottomCur.atStart() && bottom > vr.bottom()) {
-            tmp.setPosition(std::max(bottomCur.position() - 1, 0));
-            cRect = cursorRect(tmp);
-            if (tmp.block().textDirection() == Qt::RightToLeft)
-                tmp = cursorForPosition(QPoint(vr.right() + 1, cRect.center().y()));
-            else
-                tmp = cursorForPosition(QPoint(vr.left(), cRect.center().y()));
-            if (cRect.bottom() >= bottom || cRect.top() < vr.top())
-                break;
-            bottomCur.setPosition(tmp.position());
-            bottom = cRect.bottom();
-        }
-        vPos.bottomPos = bottomCur.position();
-
-        /* middle cursor */
-        int midHeight = (top + bottom + 1) / 2
-                        /* at the top of the document, the vertical
-                           offset should be taken into account */
-                        - (topCur.position() == 0 ? contentOffset().y() : 0);
-        tmp = cursorForPosition(QPoint(vr.left(), midHeight));
-        if (tmp.block().textDirection() == Qt::RightToLeft)
-            tmp = cursorForPosition(QPoint(vr.right() + 1, midHeight));
-        cRect = cursorRect(tmp);
-        if (cRect.top() >= midHeight) {
-            tmp.setPosition(std::max(tmp.position() - 1, 0));
-            cRect = cursorRect(tmp);
-            if (tmp.block().textDirection() == Qt::RightToLeft)
-                tmp = cursorForPosition(QPoint(vr.right() + 1, cRect.center().y()));
-            else
-                tmp = cursorForPosition(QPoint(vr.left(), cRect.center().y()));
-        }
-        vPos.midPos = tmp.position();
-    }
+    QTextBlock block = firstVisibleBlock();
+    if (!block.isValid())
+        return vPos;
+    vPos.block = block.blockNumber();
+    vPos.line = std::max(verticalScrollBar()->value() - block.firstLineNumber(), 0);
+    vPos.hScroll = horizontalScrollBar()->value();
+
+    /* the current cursor (if it's visible) */
+    if (viewport()->rect().contains(cursorRect().center()))
+        vPos.curPos = textCursor().position();
+
     return vPos;
 }
 /*************************/
@@ -3321,7 +4006,7 @@ void TextEdit::setViewPostion(const viewPosition vPos) {
     QTextCursor cur = textCursor();
     cur.movePosition(QTextCursor::End);
     int endPos = cur.position();
-    if (vPos.midPos < 0) {
+    if (vPos.block < 0) {
         if (vPos.curPos >= 0) {
             cur.setPosition(std::min(vPos.curPos, endPos));
             setTextCursor(cur);
@@ -3329,47 +4014,28 @@ void TextEdit::setViewPostion(const viewPosition vPos) {
         return;
     }
 
-    /* first center the middle cursor */
-    cur.setPosition(std::min(vPos.midPos, endPos));
-    setTextCursor(cur);
-    centerCursor();
-
-    /* if the middle cursor isn't at the line start, the text has changed */
-    if (auto vp = viewport()) {
-        QRect vr = vp->rect();
-        QRect cRect = cursorRect(cur);
-        QTextCursor tmp;
-        if (cur.block().textDirection() == Qt::RightToLeft)
-            tmp = cursorForPosition(QPoint(vr.right() + 1, cRect.center().y()));
-        else
-            tmp = cursorForPosition(QPoint(vr.left(), cRect.center().y()));
-        if (tmp != cur) {
-            setTextCursor(tmp);
-            centerCursor();
-            if (vPos.curPos >= 0) {
-                tmp.setPosition(std::min(vPos.curPos, endPos));
-                setTextCursor(tmp);
-            }
-            return;
-        }
-    }
+    /* the text may have changed but the anchor block is kept if it exists */
+    QTextBlock block = document()->findBlockByNumber(std::min(vPos.block, document()->blockCount() - 1));
+    document()->documentLayout()->blockBoundingRect(block);  // lays out only this block
+    QTextLayout* layout = block.layout();
+    int line = std::min(vPos.line, std::max(layout->lineCount() - 1, 0));
 
-    /* also ensure that the top and bottom cursors are visible */
-    QTextCursor tmp = cur;
-    if (vPos.topPos >= 0) {
-        tmp.setPosition(std::min(vPos.topPos, endPos));
-        setTextCursor(tmp);
-    }
-    if (vPos.bottomPos >= 0) {
-        tmp.setPosition(std::min(vPos.bottomPos, endPos));
-        setTextCursor(tmp);
-    }
-
-    /* restore the original text cursor if it's visible;
-       otherwise, go back to the middle cursor */
+    /* restore the text cursor if it was visible; otherwise, put it at the anchor */
     if (vPos.curPos >= 0)
         cur.setPosition(std::min(vPos.curPos, endPos));
+    else
+        cur.setPosition(block.position() + (layout->lineCount() > 0 ? layout->lineAt(line).textStart() : 0));
     setTextCursor(cur);
+
+    verticalScrollBar()->setValue(block.firstLineNumber() + line);
+    horizontalScrollBar()->setValue(vPos.hScroll);
+}
+/*************************/
+// Only the blocks that are changed after the previous snapshot are copied.
+DocumentSnapshot TextEdit::snapshot() {
+    if (snapshotTracker_ == nullptr)
+        snapshotTracker_ = new SnapshotTracker(document(), this);
+    return snapshotTracker_->snapshot();
 }
 
 }  // namespace FeatherPad
@@ -21,15 +21,20 @@
 #define TEXTEDIT_H
 
 #include <QPointer>
+#include <QMap>
 #include <QPlainTextEdit>
 #include <QUrl>
 #include <QMimeData>
 #include <QDateTime>
 #include <QElapsedTimer>
 #include <QSyntaxHighlighter>
+#include <QProgressDialog>
+#include "snapshot.h"
 
 namespace FeatherPad {
 
+class VScrollBar;
+
 /* This is for auto-indentation, line numbers, DnD, zooming, customized
    vertical scrollbar, appropriate signals, and saving/getting useful info. */
 class TextEdit : public QPlainTextEdit {
@@ -62,12 +67,19 @@ class TextEdit : public QPlainTextEdit {
 
     bool toSoftTabs();
 
+    bool replaceRange(int start, int end, const QString& text);
+
+    void setUndoMemoryLimit(int limit);  // in MiB
+
     QString getUrl(const int pos) const;
 
     QFont getDefaultFont() const { return font_; }
 
     QString getTextTab_() const { return textTab_; }
-    void setTtextTab(int textTabSize) { textTab_ = textTab_.leftJustified(textTabSize, ' ', true); }
+    void setTtextTab(int textTabSize) {
+        textTab_ = textTab_.leftJustified(textTabSize, ' ', true);
+        indentLevels_.clear();  // indentation widths depend on the tab size
+    }
 
     QTextEdit::ExtraSelection currentLineSelection() { return currentLine_; }
 
@@ -77,10 +89,13 @@ class TextEdit : public QPlainTextEdit {
     void setAutoReplace(bool replace) { autoReplace_ = replace; }
     bool getAutoReplace() const { return autoReplace_; }
 
-    void setDrawIndetLines(bool draw) { drawIndetLines_ = draw; }
+    void setDrawIndetLines(bool draw);
 
     void setVLineDistance(int distance) { vLineDistance_ = distance; }
 
+    VScrollBar* vScrollBar() const { return vScrollBar_; }
+    void setShowOverview(bool show);
+
     void setDateFormat(const QString& format) { dateFormat_ = format; }
 
     void setAutoBracket(bool autoB) { autoBracket_ = autoB; }
@@ -141,13 +156,11 @@ class TextEdit : public QPlainTextEdit {
     QList<QTextEdit::ExtraSelection> getBlueSel() const { return blueSel_; }
 
     bool isUneditable() const { return uneditable_; }
+    bool isPasting() const { return pasteTimerId_ != 0; }
     void makeUneditable(bool readOnly) { uneditable_ = readOnly; }
 
     QSyntaxHighlighter* getHighlighter() const { return highlighter_.data(); }
-    void setHighlighter(QSyntaxHighlighter* h) {
-        highlighter_ = h;
-        matchedBrackets_ = false;
-    }
+    void setHighlighter(QSyntaxHighlighter* h);
 
     bool getInertialScrolling() const { return inertialScrolling_; }
     void setInertialScrolling(bool inertial) { inertialScrolling_ = inertial; }
@@ -176,7 +189,32 @@ class TextEdit : public QPlainTextEdit {
 
     void removeColumnHighlight();
 
-    int selectionSize() const;
+    /* The selected characters, lines and words, measured with positions and
+       without copying the selected text. Words are counted only for selections
+       that aren't too long; otherwise, they are -1. */
+    struct selectionStats {
+        int chars;
+        int lines;
+        int words;
+    };
+    selectionStats selectionInfo() const;
+
+    /* Marks the blocks containing matches of "str" on the scrollbar.
+       The matches are found in a separate thread. An empty string
+       removes the search markers. */
+    void setSearchMarkers(const QString& str, QTextDocument::FindFlags flags, bool isRegex);
+
+    /* Produces the text of a large mouse selection that is kept lazily in the
+       selection clipboard. It should be called before the document is edited. */
+    void keepSelectionData();
+
+    /* code folding (see "folding.cpp") */
+    bool canFold() const { return !highlighter_.isNull(); }
+    bool isFoldHeader(const QTextBlock& block) const;
+    bool isFolded(const QTextBlock& block) const { return folds_.contains(block.blockNumber()); }
+    bool hasFolds() const { return !folds_.isEmpty(); }
+    void toggleFold(const QTextBlock& block);
+    void unfoldAll();
 
     QTextCursor finding(const QString& str,
                         const QTextCursor& start,
@@ -188,14 +226,18 @@ class TextEdit : public QPlainTextEdit {
      ***** View Position *****
      *************************/
     struct viewPosition {
-        int curPos{-1};
-        int topPos{-1};
-        int midPos{-1};
-        int bottomPos{-1};
+        int curPos{-1};  // The text cursor (if it's visible).
+        int block{-1};   // The first visible block.
+        int line{0};     // The first visible line of that block.
+        int hScroll{0};  // The horizontal scrollbar value.
     };
     viewPosition getViewPosition() const;
     void setViewPostion(const viewPosition vPos);
 
+    /* an immutable copy of the text for other threads (see "snapshot.h") */
+    DocumentSnapshot snapshot();
+    int snapshotRevision() const { return snapshotTracker_ ? snapshotTracker_->revision() : -1; }
+
    signals:
     /* inform the main widget */
     void filePasted(const QString& localFile,
@@ -207,7 +249,9 @@ class TextEdit : public QPlainTextEdit {
     void updateRect();
     void zoomedOut(TextEdit* textEdit);  // needed for reformatting text
     void updateBracketMatching();
+    void cursorMoved();  // emitted at most once per frame, unlike cursorPositionChanged()
     void hugeColumn();
+    void pasting(bool pasting);  // a huge text is being pasted in chunks (or it's finished)
     void canCopy(bool yes);
 
    public slots:
@@ -225,6 +269,7 @@ class TextEdit : public QPlainTextEdit {
    protected:
     void keyPressEvent(QKeyEvent* event);
     void keyReleaseEvent(QKeyEvent* event);
+    void inputMethodEvent(QInputMethodEvent* event);
     void wheelEvent(QWheelEvent* event);
     void resizeEvent(QResizeEvent* event);
     void timerEvent(QTimerEvent* event);
@@ -248,6 +293,10 @@ class TextEdit : public QPlainTextEdit {
     void highlightCurrentLine();
     void updateLineNumberArea(const QRect& rect, int dy);
     void onUpdateRequesting(const QRect&, int dy);
+    void updateIndentLevels(int position, int charsRemoved, int charsAdded);
+    void outdateSearchMarkers(int position, int charsRemoved, int charsAdded);
+    void onFoldedContentsChange(int position, int charsRemoved, int charsAdded);
+    void keepCursorOutOfFolds();
     void onSelectionChanged();
     void scrollWithInertia();
 
@@ -255,6 +304,18 @@ class TextEdit : public QPlainTextEdit {
     QString computeIndentation(const QTextCursor& cur) const;
     QString remainingSpaces(const QString& spaceTab, const QTextCursor& cursor) const;
     QTextCursor backTabCursor(const QTextCursor& cursor, bool twoSpace) const;
+    int indentLevel(const QTextBlock& block);
+    void reserveUndoMemory(qint64 chars);
+    void onUndoContentsChange(int position, int charsRemoved, int charsAdded);
+    void indexMatches();
+    void reindexEditedBlocks();
+    void scheduleUpdates(int updates);
+    void runScheduledUpdates();
+    bool indentFolding() const;
+    int foldEnd(const QTextBlock& block) const;
+    int foldMarginWidth() const;
+    void setBlocksVisible(const QTextBlock& first, const QTextBlock& last, bool visible);
+    void restoreFoldedBlocks(const QTextCursor& header, const QTextCursor& last);
     void makeColumn(const QPoint& endPoint);
     void highlightColumn(const QTextCursor& endCur, int gap);
     void prependToColumn(QKeyEvent* event);
@@ -262,15 +323,21 @@ class TextEdit : public QPlainTextEdit {
     void cutColumn();
     void deleteColumn();
     void pasteOnColumn();
+    void pasteInChunks(const QString& text);
+    void pasteNextChunk();
+    void finishChunkedPaste(bool canceled);
+    void applyZoom();
 
     int prevAnchor_, prevPos_;  // used only for bracket matching
     QWidget* lineNumberArea_;
+    VScrollBar* vScrollBar_;
     QTextEdit::ExtraSelection currentLine_;
     QRect lastCurrentLine_;
     int widestDigit_;
     bool autoIndentation_;
     bool autoReplace_;
     bool drawIndetLines_;
+    QList<int> indentLevels_;  // leading whitespace widths of blocks in columns (-1 if not computed yet)
     bool autoBracket_;
     int darkValue_;
     QColor separatorColor_;
@@ -278,10 +345,37 @@ class TextEdit : public QPlainTextEdit {
     QString dateFormat_;
     QColor lineHColor_;
     int resizeTimerId_, selectionTimerId_;  // for not wasting CPU's time
+    int matchIndexTimerId_;                 // throttles the indexing of search matches
+    /* the updates after cursor moves are done together, in this order */
+    enum scheduledUpdate { CursorUpdate = 0x1, BracketUpdate = 0x2 };
+    int scheduledUpdates_;
+    int updateTimerId_;
+    /* a huge text is pasted in chunks, inside a single edit block */
+    QString pasteText_;
+    qsizetype pastePos_;
+    QTextCursor pasteCursor_;
+    QPointer<QProgressDialog> pasteProgress_;
+    int pasteTimerId_;
+    /* while zooming, the text is scaled and the font is changed when zooming stops */
+    qreal pendingZoom_;  // the point size to zoom to (-1 if none)
+    int zoomTimerId_;
+    SnapshotTracker* snapshotTracker_;  // created with the first snapshot
+    bool matchIndexRunning_, matchIndexOutdated_;
+    /* the range of edited blocks whose matches should be re-indexed (-1 if none) */
+    int editedFirst_, editedLast_;
+    int markerBlockCount_, markerRevision_;  // for finding the edited blocks
+    QString searchMarkerStr_;  // the string whose matches are marked on the scrollbar
+    QTextDocument::FindFlags searchMarkerFlags_;
+    bool searchMarkerRegex_;
     QPoint pressPoint_;                     // used internally for hyperlinks
     bool mousePressed_;                     // used when removing the column highlight on changing the cursor position
     QFont font_;                            // used internally for keeping track of the unzoomed font
     QString textTab_;                       // text tab in terms of spaces
+    qint64 undoMemoryLimit_;                // in bytes (0 means no limit)
+    qint64 undoSize_;                       // estimated memory used by the undo stack
+    int undoRevision_;                      // for telling text changes from format changes
+    bool undoReplaying_;                    // undo commands are being replayed
+    qint64 replayedSize_;                   // the changes of the replayed undo commands (in bytes)
     QElapsedTimer tripleClickTimer_;
     /* To keep text cursor's horizontal position with Up/Down keys
        (also used in a workaround for a Qt regression): */
@@ -318,6 +412,17 @@ class TextEdit : public QPlainTextEdit {
     QPointer<QSyntaxHighlighter> highlighter_;   // syntax highlighter
     bool saveCursor_;
     bool pastePaths_;
+    /* Folded regions, keyed by the numbers of their header blocks. The cursors are at the
+       starts of the header and the last hidden block, so that they follow edits; an edit
+       inside a region unfolds it, and the keys are updated when the line count changes. */
+    struct foldRange {
+        QTextCursor header;
+        QTextCursor last;
+    };
+    QMap<int, foldRange> folds_;
+    int foldRevision_;    // for ignoring format changes
+    int foldBlockCount_;  // for updating the keys of "folds_"
+    int lastCursorBlock_;  // used for skipping folded regions with keyboard navigation
     /******************************
      ***** Inertial scrolling *****
      ******************************/
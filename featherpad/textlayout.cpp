@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) Pedram Pourang (aka Tsu Jan) 2026 <tsujan2000@gmail.com>
+ *
+ * FeatherPad is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FeatherPad is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @license GPL-3.0+ <https://spdx.org/licenses/GPL-3.0+.html>
+ */
+
+#include "textlayout.h"
+#include <QTextDocument>
+#include <QTextBlock>
+#include <QTextLayout>
+#include <QTimerEvent>
+#include <QElapsedTimer>
+#include <QFontMetricsF>
+#include <algorithm>
+
+#define LINE_COUNT_SLICE 10  // in ms
+
+namespace FeatherPad {
+
+TextLayout::TextLayout(QTextDocument* doc)
+    : QPlainTextDocumentLayout(doc),
+      charWidth_(0),
+      longestLine_(0),
+      countedWidth_(-1),
+      countTimerId_(0),
+      paused_(false),
+      nextBlock_(0),
+      remainingBlocks_(0) {}
+/*************************/
+void TextLayout::setCharWidth(qreal width) {
+    width = std::max(width, static_cast<qreal>(0));
+    if (width == charWidth_)
+        return;
+    bool wasFixed(charWidth_ > 0);
+    charWidth_ = width;
+    if (charWidth_ > 0 && !wasFixed) {
+        QTextDocument* doc = document();
+        longestLine_ = findLongestLine(doc->firstBlock(), doc->lastBlock());
+    }
+    emit documentSizeChanged(documentSize());
+}
+/*************************/
+bool TextLayout::isFixedPitch() const {
+    return charWidth_ > 0 && document()->defaultTextOption().wrapMode() == QTextOption::NoWrap;
+}
+/*************************/
+// The width of the laid out blocks is also considered because a line may
+// have tabs or wide characters.
+QSizeF TextLayout::documentSize() const {
+    QSizeF size = QPlainTextDocumentLayout::documentSize();
+    if (isFixedPitch()) {
+        size.setWidth(std::max(size.width(),
+                               longestLine_ * charWidth_ + 2 * document()->documentMargin() + cursorWidth()));
+    }
+    return size;
+}
+/*************************/
+// Also called with the whole text when the default font or text option is changed.
+QRectF TextLayout::blockBoundingRect(const QTextBlock& block) const {
+    if (document()->defaultTextOption().wrapMode() == QTextOption::NoWrap)
+        const_cast<TextLayout*>(this)->countedWidth_ = -1;
+    else if (countedWidth_ != textWidth() && textWidth() > 0 && block.isValid())  // start from this block
+        const_cast<TextLayout*>(this)->startCountingLines(block.blockNumber());
+    return QPlainTextDocumentLayout::blockBoundingRect(block);
+}
+/*************************/
+void TextLayout::documentChanged(int from, int charsRemoved, int charsAdded) {
+    QPlainTextDocumentLayout::documentChanged(from, charsRemoved, charsAdded);
+    QTextDocument* doc = document();
+    bool wholeText(from == 0 && charsAdded >= doc->characterCount() - 1);
+    if (wholeText)
+        countedWidth_ = -1;  // count the wrapped lines again
+    if (charWidth_ <= 0)
+        return;  // the line lengths aren't needed
+    if (wholeText)
+        longestLine_ = 0;
+    int longest = findLongestLine(doc->findBlock(from), doc->findBlock(from + charsAdded));
+    if (longest > longestLine_) {
+        longestLine_ = longest;
+        if (isFixedPitch())
+            emit documentSizeChanged(documentSize());
+    }
+}
+/*************************/
+void TextLayout::startCountingLines(int blockNumber) {
+    countedWidth_ = textWidth();
+    nextBlock_ = blockNumber;
+    remainingBlocks_ = document()->blockCount();
+    if (countTimerId_ == 0 && !paused_)
+        countTimerId_ = startTimer(0);
+}
+/*************************/
+void TextLayout::setPaused(bool paused) {
+    if (paused_ == paused)
+        return;
+    paused_ = paused;
+    if (paused) {
+        if (countTimerId_) {
+            killTimer(countTimerId_);
+            countTimerId_ = 0;
+        }
+    }
+    else if (remainingBlocks_ > 0 && countedWidth_ >= 0 && countTimerId_ == 0)
+        countTimerId_ = startTimer(0);  // continue counting
+}
+/*************************/
+// Counts the lines of a wrapped block, like QPlainTextDocumentLayout::layoutBlock(),
+// but with a temporary layout. The count is corrected when the block is laid out.
+void TextLayout::countLines(QTextBlock block) const {
+    if (!block.isVisible() || block.layout()->lineCount() > 0)
+        return;  // folded or already laid out
+    const QString text = block.text();
+    if (text.isEmpty())
+        return;  // always one line
+    QTextDocument* doc = document();
+    const QTextOption option = doc->defaultTextOption();
+    QTextLayout layout(text, doc->defaultFont());
+    layout.setTextOption(option);
+    layout.setFormats(block.layout()->formats());  // the formats of the highlighter are kept
+    qreal width = countedWidth_ - 2 * doc->documentMargin();
+    if (option.flags() & QTextOption::AddSpaceForLineAndParagraphSeparators)
+        width -= QFontMetricsF(block.charFormat().font()).horizontalAdvance(QChar(0x21B5));
+    int lines = 0;
+    layout.beginLayout();
+    for (;;) {
+        QTextLine line = layout.createLine();
+        if (!line.isValid())
+            break;
+        line.setLeadingIncluded(true);
+        line.setLineWidth(width);
+        ++lines;
+    }
+    layout.endLayout();
+    block.setLineCount(std::max(lines, 1));
+}
+/*************************/
+void TextLayout::timerEvent(QTimerEvent* event) {
+    if (event->timerId() != countTimerId_) {
+        QPlainTextDocumentLayout::timerEvent(event);
+        return;
+    }
+    QTextDocument* doc = document();
+    if (countedWidth_ != textWidth() || doc->defaultTextOption().wrapMode() == QTextOption::NoWrap) {
+        /* the counting will be restarted if needed */
+        killTimer(countTimerId_);
+        countTimerId_ = 0;
+        return;
+    }
+
+    const int lineCount = doc->lineCount();
+    QTextBlock block = doc->findBlockByNumber(nextBlock_);
+    if (!block.isValid())
+        block = doc->firstBlock();
+    QElapsedTimer timer;
+    timer.start();
+    while (remainingBlocks_ > 0 && !timer.hasExpired(LINE_COUNT_SLICE)) {
+        countLines(block);
+        --remainingBlocks_;
+        block = block.next();
+        if (!block.isValid())
+            block = doc->firstBlock();  // the blocks before the start
+    }
+    nextBlock_ = block.blockNumber();
+    if (remainingBlocks_ <= 0) {
+        killTimer(countTimerId_);
+        countTimerId_ = 0;
+    }
+
+    /* adjust the scrollbars once per slice */
+    if (doc->lineCount() != lineCount)
+        emit documentSizeChanged(documentSize());
+}
+/*************************/
+int TextLayout::findLongestLine(const QTextBlock& first, const QTextBlock& last) const {
+    int longest = 0;
+    QTextBlock block = first;
+    while (block.isValid()) {
+        longest = std::max(longest, block.length() - 1);
+        if (block == last)
+            break;
+        block = block.next();
+    }
+    return longest;
+}
+
+}  // namespace FeatherPad
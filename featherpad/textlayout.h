@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) Pedram Pourang (aka Tsu Jan) 2026 <tsujan2000@gmail.com>
+ *
+ * FeatherPad is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FeatherPad is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @license GPL-3.0+ <https://spdx.org/licenses/GPL-3.0+.html>
+ */
+
+#ifndef TEXTLAYOUT_H
+#define TEXTLAYOUT_H
+
+#include <QPlainTextDocumentLayout>
+
+namespace FeatherPad {
+
+/* The document layout of TextEdit. QPlainTextDocumentLayout lays out blocks
+   lazily and finds the document width only from the laid out blocks. When the
+   text isn't wrapped and its font is monospace, this layout finds the width
+   from line lengths instead, without shaping lines that aren't visible. So,
+   the horizontal scrollbar covers the longest line from the start, and its
+   range doesn't change while scrolling a huge file.
+
+   When the text is wrapped, QPlainTextDocumentLayout counts a block that
+   isn't laid out as one line. After the text width is changed, this layout
+   counts the wrapped lines of such blocks in idle time slices, starting from
+   the visible part, so that the vertical scrollbar becomes precise without
+   blocking the GUI or keeping the layouts of invisible blocks in memory. */
+class TextLayout : public QPlainTextDocumentLayout {
+    Q_OBJECT
+
+   public:
+    TextLayout(QTextDocument* doc);
+
+    /* The fixed-pitch mode is turned on with the character width of a monospace font. */
+    void setCharWidth(qreal width);
+    bool isFixedPitch() const;
+    /* Pauses counting lines (while the document is being edited in chunks, for example). */
+    void setPaused(bool paused);
+
+    QSizeF documentSize() const override;
+    QRectF blockBoundingRect(const QTextBlock& block) const override;
+
+   protected:
+    void documentChanged(int from, int charsRemoved, int charsAdded) override;
+    void timerEvent(QTimerEvent* event) override;
+
+   private:
+    int findLongestLine(const QTextBlock& first, const QTextBlock& last) const;
+    void startCountingLines(int blockNumber);
+    void countLines(QTextBlock block) const;
+
+    qreal charWidth_;
+    int longestLine_;  // in characters (it doesn't shrink with editing)
+    // Counting wrapped lines:
+    qreal countedWidth_;  // the text width for which lines are counted (-1 if none)
+    int countTimerId_;
+    bool paused_;
+    int nextBlock_;
+    int remainingBlocks_;
+};
+
+}  // namespace FeatherPad
+
+#endif  // TEXTLAYOUT_H
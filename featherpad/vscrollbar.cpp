@@ -19,12 +19,53 @@
 
 #include "vscrollbar.h"
 
+#include <QPainter>
+#include <QStyleOptionSlider>
+#include <QTextBlock>
+
 #include <algorithm>
 #include <cmath>
 
+#define DENSITY_INTERVAL 300  // in ms
+
 namespace FeatherPad {
 
-VScrollBar::VScrollBar(QWidget* parent) : QScrollBar(parent) {}
+DensityMap::DensityMap(const QList<int>& lineLengths, const QSize& size, const QColor& color)
+    : QThread(), lineLengths_(lineLengths), size_(size), color_(color) {}
+/*************************/
+void DensityMap::run() {
+    QImage image(size_, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    const qint64 lines = lineLengths_.size();
+    const int width = size_.width();
+    const int height = size_.height();
+    if (lines > 0 && width > 0 && height > 0) {
+        constexpr double maxLength = 120;  // longer lines are drawn with the full width
+        const QRgb pixel = qPremultiply(color_.rgba());
+        /* each row shows the average length of the lines it covers */
+        for (int row = 0; row < height; ++row) {
+            const qint64 first = lines * row / height;
+            const qint64 last = std::min(std::max(first + 1, lines * (row + 1) / height), lines);
+            qint64 sum = 0;
+            for (qint64 i = first; i < last; ++i)
+                sum += lineLengths_.at(i);
+            const double average = static_cast<double>(sum) / static_cast<double>(last - first);
+            const int w = std::round(static_cast<double>(width) * std::min(average, maxLength) / maxLength);
+            QRgb* scanLine = reinterpret_cast<QRgb*>(image.scanLine(row));
+            std::fill(scanLine, scanLine + w, pixel);
+        }
+    }
+    emit ready(image);
+}
+/*************************/
+VScrollBar::VScrollBar(QWidget* parent)
+    : QScrollBar(parent),
+      blockCount_(0),
+      overview_(false),
+      markerRowsDirty_(false),
+      densityTimerId_(0),
+      densityRunning_(false),
+      densityOutdated_(false) {}
 /*************************/
 void VScrollBar::wheelEvent(QWheelEvent* event) {
     if (!underMouse() || !event->spontaneous() ||
@@ -48,5 +89,199 @@ void VScrollBar::wheelEvent(QWheelEvent* event) {
     _effectiveDelta = 0;
     setSliderPosition(sliderPosition() + step);
 }
+/*************************/
+void VScrollBar::setDocument(QTextDocument* doc) {
+    if (doc_ == doc)
+        return;
+    if (doc_)
+        disconnect(doc_, &QTextDocument::contentsChange, this, &VScrollBar::onContentsChange);
+    doc_ = doc;
+    blockCount_ = doc_ ? doc_->blockCount() : 0;
+    for (auto& markers : markers_)
+        markers.clear();
+    if (doc_)
+        connect(doc_, &QTextDocument::contentsChange, this, &VScrollBar::onContentsChange);
+    resetLineLengths();
+    markerRowsDirty_ = true;
+    update();
+}
+/*************************/
+void VScrollBar::setOverview(bool overview) {
+    if (overview_ == overview)
+        return;
+    overview_ = overview;
+    resetLineLengths();
+    update();
+}
+/*************************/
+void VScrollBar::resetLineLengths() {
+    lineLengths_.clear();
+    densityMap_ = QImage();
+    if (doc_ && overview_) {
+        lineLengths_.reserve(doc_->blockCount());
+        for (QTextBlock block = doc_->firstBlock(); block.isValid(); block = block.next())
+            lineLengths_.append(block.length() - 1);
+        updateDensityMap();
+    }
+}
+/*************************/
+void VScrollBar::setMarkers(MarkerType type, const QList<int>& blockNumbers) {
+    if (markers_[type].isEmpty() && blockNumbers.isEmpty())
+        return;
+    markers_[type] = blockNumbers;
+    std::sort(markers_[type].begin(), markers_[type].end());
+    markerRowsDirty_ = true;
+    update();
+}
+/*************************/
+void VScrollBar::addMarker(MarkerType type, int blockNumber) {
+    QList<int>& markers = markers_[type];
+    markers.insert(std::lower_bound(markers.begin(), markers.end(), blockNumber), blockNumber);
+    markerRowsDirty_ = true;
+    update();
+}
+/*************************/
+void VScrollBar::removeMarker(MarkerType type, int blockNumber) {
+    QList<int>& markers = markers_[type];
+    auto it = std::lower_bound(markers.begin(), markers.end(), blockNumber);
+    if (it != markers.end() && *it == blockNumber) {
+        markers.erase(it);
+        markerRowsDirty_ = true;
+        update();
+    }
+}
+/*************************/
+// Updates the lengths of the changed blocks, shifts the markers and
+// renders the density map again when the changes pause.
+void VScrollBar::onContentsChange(int position, int /*charsRemoved*/, int charsAdded) {
+    if (!doc_)
+        return;
+    const int count = doc_->blockCount();
+    const int diff = count - blockCount_;
+    blockCount_ = count;
+    QTextBlock block = doc_->findBlock(position);
+    const int first = block.isValid() ? block.blockNumber() : 0;
+
+    if (diff != 0) {
+        /* the markers of removed blocks go to the first changed block */
+        for (auto& markers : markers_) {
+            for (int& m : markers) {
+                if (m > first)
+                    m = std::max(m + diff, first);
+            }
+        }
+        markerRowsDirty_ = true;
+        update();
+    }
+
+    if (!overview_)
+        return;
+    const int size = lineLengths_.size();
+    if (!block.isValid() || size != count - diff || first >= size || (diff < 0 && first + 1 - diff > size)) {
+        resetLineLengths();  // a precaution
+        return;
+    }
+    if (diff > 0)
+        lineLengths_.insert(first + 1, diff, 0);
+    else if (diff < 0)
+        lineLengths_.remove(first + 1, -diff);
+    QTextBlock lastBlock = doc_->findBlock(position + charsAdded);
+    const int last = lastBlock.isValid() ? lastBlock.blockNumber() : count - 1;
+    for (int i = first; i <= last && block.isValid(); ++i, block = block.next())
+        lineLengths_[i] = block.length() - 1;
+
+    if (densityTimerId_ == 0)
+        densityTimerId_ = startTimer(DENSITY_INTERVAL);
+}
+/*************************/
+void VScrollBar::timerEvent(QTimerEvent* event) {
+    if (event->timerId() == densityTimerId_) {
+        killTimer(densityTimerId_);
+        densityTimerId_ = 0;
+        updateDensityMap();
+    }
+    else
+        QScrollBar::timerEvent(event);
+}
+/*************************/
+void VScrollBar::resizeEvent(QResizeEvent* event) {
+    QScrollBar::resizeEvent(event);
+    markerRowsDirty_ = true;
+    if (overview_ && densityTimerId_ == 0)
+        densityTimerId_ = startTimer(DENSITY_INTERVAL);
+}
+/*************************/
+QRect VScrollBar::grooveRect() const {
+    QStyleOptionSlider opt;
+    initStyleOption(&opt);
+    return style()->subControlRect(QStyle::CC_ScrollBar, &opt, QStyle::SC_ScrollBarGroove, this);
+}
+/*************************/
+void VScrollBar::updateDensityMap() {
+    if (!doc_ || !overview_)
+        return;
+    if (densityRunning_) {  // render it again when the current rendering is finished
+        densityOutdated_ = true;
+        return;
+    }
+    const QRect groove = grooveRect();
+    if (groove.isEmpty())
+        return;
+    densityRunning_ = true;
+    densityOutdated_ = false;
+    DensityMap* thread = new DensityMap(lineLengths_, groove.size(), palette().color(QPalette::WindowText));
+    connect(thread, &DensityMap::ready, this, [this](const QImage& image) {
+        if (overview_) {
+            densityMap_ = image;
+            update();
+        }
+    });
+    connect(thread, &QThread::finished, this, [this] {
+        densityRunning_ = false;
+        if (densityOutdated_)
+            updateDensityMap();
+    });
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    thread->start(QThread::LowPriority);
+}
+/*************************/
+void VScrollBar::paintEvent(QPaintEvent* event) {
+    QScrollBar::paintEvent(event);
+    if (!doc_ || (!overview_ && markers_[SearchMarker].isEmpty() && markers_[ReplaceMarker].isEmpty() &&
+                  markers_[SpellMarker].isEmpty())) {
+        return;
+    }
+    const QRect groove = grooveRect();
+    if (groove.isEmpty())
+        return;
+
+    QPainter painter(this);
+    if (!densityMap_.isNull()) {
+        painter.setOpacity(0.3);
+        painter.drawImage(groove, densityMap_);
+        painter.setOpacity(1);
+    }
+
+    const int h = groove.height();
+    if (markerRowsDirty_) {
+        markerRowsDirty_ = false;
+        const qint64 lines = std::max(blockCount_, 1);
+        for (int i = 0; i < MarkerTypes; ++i) {
+            QList<int>& rows = markerRows_[i];
+            rows.clear();
+            for (const int m : std::as_const(markers_[i])) {
+                const int row = std::min(static_cast<int>(static_cast<qint64>(m) * h / lines), h - 2);
+                if (rows.isEmpty() || rows.last() != row)
+                    rows.append(row);
+            }
+        }
+    }
+
+    static const QColor markerColors[MarkerTypes] = {QColor(255, 190, 0), QColor(0, 180, 0), QColor(220, 0, 0)};
+    for (int i = 0; i < MarkerTypes; ++i) {
+        for (const int row : std::as_const(markerRows_[i]))
+            painter.fillRect(QRect(groove.left(), groove.top() + row, groove.width(), 2), markerColors[i]);
+    }
+}
 
 }  // namespace FeatherPad
@@ -22,18 +22,77 @@
 
 #include <QScrollBar>
 #include <QWheelEvent>
+#include <QThread>
+#include <QPointer>
+#include <QTextDocument>
+#include <QImage>
 
 namespace FeatherPad {
 
-/* We want faster mouse wheel scrolling
-   when the mouse cursor is on the scrollbar. */
+/* Renders a downsampled map of line lengths in a separate thread. */
+class DensityMap : public QThread {
+    Q_OBJECT
+
+   public:
+    DensityMap(const QList<int>& lineLengths, const QSize& size, const QColor& color);
+
+   signals:
+    void ready(const QImage& image);
+
+   private:
+    void run() override;
+
+    QList<int> lineLengths_;
+    QSize size_;
+    QColor color_;
+};
+
+/* We want faster mouse wheel scrolling when the mouse cursor is on the
+   scrollbar. The scrollbar also shows markers (search matches, etc.) and
+   can show an overview of the document, namely a density map of line lengths. */
 class VScrollBar : public QScrollBar {
     Q_OBJECT
    public:
+    enum MarkerType { SearchMarker = 0, ReplaceMarker, SpellMarker, MarkerTypes };
+
     VScrollBar(QWidget* parent = nullptr);
 
+    void setDocument(QTextDocument* doc);  // needed for markers and the overview
+    void setOverview(bool overview);
+    bool hasOverview() const { return overview_; }
+
+    /* markers are block numbers */
+    void setMarkers(MarkerType type, const QList<int>& blockNumbers);
+    void addMarker(MarkerType type, int blockNumber);
+    void removeMarker(MarkerType type, int blockNumber);
+    void clearMarkers(MarkerType type) { setMarkers(type, QList<int>()); }
+    const QList<int>& markers(MarkerType type) const { return markers_[type]; }
+
    protected:
     void wheelEvent(QWheelEvent* event) override;
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void timerEvent(QTimerEvent* event) override;
+
+   private slots:
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
+
+   private:
+    QRect grooveRect() const;
+    void updateDensityMap();
+    void resetLineLengths();
+
+    QPointer<QTextDocument> doc_;
+    int blockCount_;
+    bool overview_;
+    QList<int> lineLengths_;              // lengths of blocks, updated incrementally (only with the overview)
+    QList<int> markers_[MarkerTypes];     // sorted block numbers
+    QList<int> markerRows_[MarkerTypes];  // y-coordinates of markers inside the groove
+    bool markerRowsDirty_;
+    QImage densityMap_;
+    int densityTimerId_;
+    bool densityRunning_;   // is a density map being rendered?
+    bool densityOutdated_;  // should the density map be rendered again?
 };
 
 }  // namespace FeatherPad